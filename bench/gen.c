@@ -0,0 +1,186 @@
+// Generates synthetic programs of a given shape and size to benchmark the
+// compiler with. Every shape repeats a small unit of code until the output
+// reaches the requested size, each unit declaring fresh variables so that
+// the programs also pass the semantic checks. The variables every unit
+// starts from are read in, so that none of it is folded away before it is
+// lowered. The output only depends on the arguments, so the same corpus can
+// be regenerated to compare commits. The units of the deep shape each open a
+// statement inside the one of the unit before, so that the program nests
+// deeper the bigger it is, and are all closed at the end.
+// Usage: gen <shape> <size>[K|M] <output file>
+// Shapes: vars, exprs, nesting, deep, comments, literals
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// An expression is this many comparisons, each between two chains of
+// arithmetic, joined by `and` and `or`
+#define EXPR_COMPARISONS 8
+#define EXPR_SIDE_LENGTH 4
+#define NESTING_DEPTH 48
+// As many digits as always fit in 64 bits
+#define LITERAL_DIGITS 19
+#define LITERALS_PER_UNIT 4
+
+static const char *arithmetic[] = {"+", "-", "*", "/", "%"};
+static const char *comparisons[] = {"<", "<=", ">", ">=", "==", "<>"};
+static const char *logic[] = {"and", "or"};
+#define COUNT_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+// SplitMix64, seeded with a constant so that the output is reproducible.
+static uint64_t next_random(uint64_t *state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15u);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+	return z ^ (z >> 31);
+}
+
+// Each unit declares `v<unit>` and may refer to the variables of the
+// prologue, `a`, `b` and `c`, which are always in scope.
+typedef void (*unit_fn)(FILE *out, uint64_t unit, uint64_t *state);
+
+static void unit_vars(FILE *out, uint64_t unit, uint64_t *state) {
+	uint64_t value = next_random(state) % 100000;
+	fprintf(out, "var v%" PRIu64 ": ", unit);
+	switch(next_random(state) % 3) {
+		case 0: fprintf(out, "nat = %" PRIu64, value); break;
+		case 1: fprintf(out, "int = -%" PRIu64, value); break;
+		default: fprintf(out, "bool = %s", value % 2 == 0 ? "true" : "false");
+	}
+	fprintf(out, ", w%" PRIu64 " = a;\n", unit);
+}
+
+// A chain of arithmetic on the prologue variables, which is a nat or an int.
+static void arithmetic_chain(FILE *out, uint64_t *state) {
+	for(unsigned i=0; i<EXPR_SIDE_LENGTH; i++) {
+		uint64_t pick = next_random(state);
+		if(i > 0) fprintf(out, " %s ", arithmetic[pick % COUNT_OF(arithmetic)]);
+		// Sprinkle in unary operators and parentheses every so often
+		const char *prefix = pick % 7 == 0 ? "-" : "";
+		if(pick % 5 == 0) fprintf(out, "(%sb * %" PRIu64 ")", prefix, pick % 1000);
+		else fprintf(out, "%s%c", prefix, "abc"[pick % 3]);
+	}
+}
+
+static void unit_exprs(FILE *out, uint64_t unit, uint64_t *state) {
+	fprintf(out, "var v%" PRIu64 " =", unit);
+	for(unsigned i=0; i<EXPR_COMPARISONS; i++) {
+		uint64_t pick = next_random(state);
+		if(i > 0) fprintf(out, " %s", logic[pick % COUNT_OF(logic)]);
+		fputs(pick % 11 == 0 ? " not " : " ", out);
+		arithmetic_chain(out, state);
+		fprintf(out, " %s ", comparisons[pick % COUNT_OF(comparisons)]);
+		arithmetic_chain(out, state);
+	}
+	fputs(";\n", out);
+}
+
+static void unit_nesting(FILE *out, uint64_t unit, uint64_t *state) {
+	(void) state;
+	for(unsigned i=0; i<NESTING_DEPTH; i++) {
+		for(unsigned j=0; j<i; j++) fputc('\t', out);
+		// Alternate between the three kinds of nested statements
+		switch(i % 3) {
+			case 0: fputs("do\n", out); break;
+			case 1: fputs("while a < b do\n", out); break;
+			case 2: fputs("if a > b do\n", out); break;
+		}
+	}
+	for(unsigned j=0; j<NESTING_DEPTH; j++) fputc('\t', out);
+	fprintf(out, "var v%" PRIu64 " = ((((a + b) * c) - a) / b);\n", unit);
+	for(unsigned i=NESTING_DEPTH; i-- > 0; ) {
+		for(unsigned j=0; j<i; j++) fputc('\t', out);
+		fputs("end\n", out);
+	}
+}
+
+static void unit_deep(FILE *out, uint64_t unit, uint64_t *state) {
+	(void) state;
+	// Not indented, that would make the output grow with the square of the depth
+	switch(unit % 3) {
+		case 0: fputs("do\n", out); break;
+		case 1: fputs("while a < b do\n", out); break;
+		case 2: fputs("if a > b do\n", out); break;
+	}
+	// Each level builds on the one around it and changes a variable of the
+	// prologue, which every loop around it has to carry along
+	if(unit == 0) fputs("var v0 = a;\n", out);
+	else fprintf(out, "var v%" PRIu64 " = v%" PRIu64 " + a;\n", unit, unit - 1);
+	fprintf(out, "c = c + v%" PRIu64 ";\n", unit);
+}
+
+static void unit_comments(FILE *out, uint64_t unit, uint64_t *state) {
+	fputs("/* This block comment is here to make the lexer skip a lot of\n", out);
+	fputs(" * text without producing any tokens, like documentation does.\n", out);
+	for(unsigned i=0, lines = next_random(state) % 8; i<lines; i++)
+		fputs(" * Lorem ipsum dolor sit amet, consectetur adipiscing elit.\n", out);
+	fputs(" */\n", out);
+	fprintf(out, "var v%" PRIu64 " = a; // and a line comment after a statement\n", unit);
+	fputs("// followed by a line comment of its own\n", out);
+}
+
+static void unit_literals(FILE *out, uint64_t unit, uint64_t *state) {
+	fprintf(out, "var v%" PRIu64 " = a", unit);
+	for(unsigned i=0; i<LITERALS_PER_UNIT; i++) {
+		fprintf(out, " + %c", (char) ('1' + next_random(state) % 9));
+		for(unsigned j=1; j<LITERAL_DIGITS; j++) fputc('0' + next_random(state) % 10, out);
+	}
+	fputs(";\n", out);
+}
+
+static const struct shape {
+	const char *name;
+	unit_fn unit;
+	// Written once for every unit after the last one, if the units nest
+	const char *close;
+} shapes[] = {
+	{"vars", unit_vars, NULL}, {"exprs", unit_exprs, NULL},
+	{"nesting", unit_nesting, NULL}, {"deep", unit_deep, "end\n"},
+	{"comments", unit_comments, NULL}, {"literals", unit_literals, NULL}
+};
+
+static bool parse_size(const char *string, long *size) {
+	char *end;
+	long value = strtol(string, &end, 10);
+	if(end == string || value <= 0) return false;
+	if(strcmp(end, "K") == 0) value *= 1024;
+	else if(strcmp(end, "M") == 0) value *= 1024 * 1024;
+	else if(*end != '\0') return false;
+	*size = value;
+	return true;
+}
+
+int main(int argc, char **argv) {
+	const struct shape *shape = NULL;
+	long size = 0;
+	if(argc == 4) for(size_t i=0; i<COUNT_OF(shapes); i++)
+		if(strcmp(argv[1], shapes[i].name) == 0) shape = &shapes[i];
+	if(shape == NULL || !parse_size(argv[2], &size)) {
+		fprintf(stderr, "Usage: %s <shape> <size>[K|M] <output file>\n", argv[0]);
+		fprintf(stderr, "Shapes: vars, exprs, nesting, deep, comments, literals\n");
+		return EXIT_FAILURE;
+	}
+
+	FILE *out = fopen(argv[3], "w");
+	if(out == NULL) {
+		perror(argv[3]);
+		return EXIT_FAILURE;
+	}
+
+	uint64_t state = 0, unit = 0;
+	// The closing text of the units so far counts towards the size already
+	long close = shape->close == NULL ? 0 : (long) strlen(shape->close);
+	fputs("var a: nat = read(), b: nat = read(), c: nat = read();\n", out);
+	for(; ftell(out) + (long) unit * close < size; unit++) shape->unit(out, unit, &state);
+	for(uint64_t i=0; i<unit && close > 0; i++) fputs(shape->close, out);
+
+	if(fclose(out) != 0) {
+		perror(argv[3]);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
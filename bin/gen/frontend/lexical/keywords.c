@@ -0,0 +1,91 @@
+// Generated by tools/keygen.c from FOREACH_KEYWORD, do not edit.
+
+#include "frontend/lexical/keywords.h"
+
+#include <stdint.h>
+
+#define KEYWORD_HASH(word) ((size_t) (((word) * UINT64_C(0xD81A8D2B5A4485AD)) >> 59))
+
+// Keeps the first N characters of a word read from the source.
+static const uint64_t keyword_masks[KEYWORD_MAX_LENGTH + 1] = {
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x00000000000000FF),
+	UINT64_C(0x000000000000FFFF),
+	UINT64_C(0x0000000000FFFFFF),
+	UINT64_C(0x00000000FFFFFFFF),
+	UINT64_C(0x000000FFFFFFFFFF),
+	UINT64_C(0x0000FFFFFFFFFFFF),
+	UINT64_C(0x00FFFFFFFFFFFFFF),
+	UINT64_C(0xFFFFFFFFFFFFFFFF),
+};
+
+// The keyword occupying each slot as a word, zero if unoccupied.
+static const uint64_t keyword_words[32] = {
+	UINT64_C(0x0000000000746E69), // int
+	UINT64_C(0x000000656C696877), // while
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x00006E7275746572), // return
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000000006669), // if
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x00000000006C696E), // nil
+	UINT64_C(0x0000000000746F6E), // not
+	UINT64_C(0x0000000065757274), // true
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000000646E61), // and
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x000000000000726F), // or
+	UINT64_C(0x0000000000726176), // var
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000066696C65), // elif
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x000000006C6F6F62), // bool
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x00000065736C6166), // false
+	UINT64_C(0x0000000000646E65), // end
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x000000000074616E), // nat
+	UINT64_C(0x0000000000006F64), // do
+	UINT64_C(0x0000000000000000),
+	UINT64_C(0x0000000065736C65), // else
+};
+
+static const uint8_t keyword_types[32] = {
+	TOK_TYPE_INT,
+	TOK_KW_WHILE,
+	TOK_IDENT,
+	TOK_IDENT,
+	TOK_KW_RETURN,
+	TOK_IDENT,
+	TOK_KW_IF,
+	TOK_IDENT,
+	TOK_IDENT,
+	TOK_KW_NIL,
+	TOK_KW_NOT,
+	TOK_KW_TRUE,
+	TOK_IDENT,
+	TOK_KW_AND,
+	TOK_IDENT,
+	TOK_IDENT,
+	TOK_KW_OR,
+	TOK_KW_VAR,
+	TOK_IDENT,
+	TOK_IDENT,
+	TOK_KW_ELIF,
+	TOK_IDENT,
+	TOK_IDENT,
+	TOK_TYPE_BOOL,
+	TOK_IDENT,
+	TOK_KW_FALSE,
+	TOK_KW_END,
+	TOK_IDENT,
+	TOK_TYPE_NAT,
+	TOK_KW_DO,
+	TOK_IDENT,
+	TOK_KW_ELSE,
+};
@@ -0,0 +1,564 @@
+// Generated by tools/llgen.c from grammar.bnf, do not edit.
+
+#ifndef LOOKAHEADS_H
+#define LOOKAHEADS_H
+
+#include "frontend/lexical/lexer.h"
+
+#define PROGRAM_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define PROGRAM_FOLLOWS \
+	/*case*/ TOK_EOF/*:*/
+
+#define TOP_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define TOP_FOLLOWS \
+	/*case*/ TOK_EOF/*:*/
+
+#define ITEM_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define ITEM_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define BLOCK_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define BLOCK_FOLLOWS \
+	/*case*/ TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE/*:*/
+
+#define ITEMS_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define ITEMS_FOLLOWS \
+	/*case*/ TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE/*:*/
+
+#define VAR_FIRSTS \
+	/*case*/ TOK_IDENT/*:*/
+
+#define VAR_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define STMT_EXPR_TAIL_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define STMT_EXPR_TAIL_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_COMMA: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define TYPE_FIRSTS \
+	/*case*/ TOK_COLON/*:*/
+
+#define TYPE_FOLLOWS \
+	/*case*/ TOK_OP_ASSIGN/*:*/
+
+#define VAR_INIT_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define VAR_INIT_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define EXPR_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define EXPR_FOLLOWS \
+	/*case*/ TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_SEMICOLON: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE/*:*/
+
+#define VAR_EXPR_NEXT_FIRSTS \
+	/*case*/ TOK_COMMA: \
+	case TOK_SEMICOLON/*:*/
+
+#define VAR_EXPR_NEXT_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define STMT_FIRSTS \
+	/*case*/ TOK_KW_DO: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE/*:*/
+
+#define STMT_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_COMMA: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define VAR_STMT_NEXT_FIRSTS \
+	/*case*/ TOK_COMMA/*:*/
+
+#define VAR_STMT_NEXT_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define TYPE_TAIL_FIRSTS \
+	/*case*/ TOK_TYPE_NAT: \
+	case TOK_TYPE_INT: \
+	case TOK_TYPE_BOOL/*:*/
+
+#define TYPE_TAIL_FOLLOWS \
+	/*case*/ TOK_OP_ASSIGN/*:*/
+
+#define NESTED_FIRSTS \
+	/*case*/ TOK_KW_DO: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE/*:*/
+
+#define NESTED_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define STMT_INNER_FIRSTS \
+	/*case*/ TOK_KW_DO: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE/*:*/
+
+#define STMT_INNER_FOLLOWS \
+	/*case*/ TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE/*:*/
+
+#define STMT_EXPR_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_DO: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define STMT_EXPR_FOLLOWS \
+	/*case*/ TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE/*:*/
+
+#define CONTENT_FIRSTS \
+	/*case*/ TOK_COLON: \
+	case TOK_KW_DO/*:*/
+
+#define CONTENT_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define BODY_FIRSTS \
+	/*case*/ TOK_COLON: \
+	case TOK_KW_DO/*:*/
+
+#define BODY_FOLLOWS \
+	/*case*/ TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE/*:*/
+
+#define ELIF_FIRSTS \
+	/*case*/ TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE/*:*/
+
+#define ELIF_FOLLOWS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_VAR: \
+	case TOK_KW_RETURN: \
+	case TOK_KW_IF: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_KW_WHILE: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_EOF: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define ATOM_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND: \
+	case TOK_KW_TRUE: \
+	case TOK_KW_FALSE: \
+	case TOK_KW_NIL: \
+	case TOK_IDENT: \
+	case TOK_LIT_NUM: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_KW_NOT/*:*/
+
+#define ATOM_FOLLOWS \
+	/*case*/ TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_SEMICOLON: \
+	case TOK_OP_ASSIGN: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_OP_ASSIGN_ALT: \
+	case TOK_OP_COMPARE: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_OP_MULT: \
+	case TOK_OP_DIV: \
+	case TOK_OP_MOD: \
+	case TOK_KW_AND: \
+	case TOK_KW_OR/*:*/
+
+#define EXPR_TAIL_FIRSTS \
+	/*case*/ TOK_OP_ASSIGN: \
+	case TOK_OP_ASSIGN_ALT: \
+	case TOK_OP_COMPARE: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_OP_MULT: \
+	case TOK_OP_DIV: \
+	case TOK_OP_MOD: \
+	case TOK_KW_AND: \
+	case TOK_KW_OR/*:*/
+
+#define EXPR_TAIL_FOLLOWS \
+	/*case*/ TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_SEMICOLON: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE/*:*/
+
+#define ATOM_TAIL_FIRSTS \
+	/*case*/ TOK_OPEN_ROUND/*:*/
+
+#define ATOM_TAIL_FOLLOWS \
+	/*case*/ TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_SEMICOLON: \
+	case TOK_OP_ASSIGN: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_OP_ASSIGN_ALT: \
+	case TOK_OP_COMPARE: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_OP_MULT: \
+	case TOK_OP_DIV: \
+	case TOK_OP_MOD: \
+	case TOK_KW_AND: \
+	case TOK_KW_OR/*:*/
+
+#define ARGS_FIRSTS \
+	/*case*/ TOK_CLOSE_ROUND/*:*/
+
+#define ARGS_FOLLOWS \
+	/*case*/ TOK_CLOSE_ROUND: \
+	case TOK_COMMA: \
+	case TOK_COLON: \
+	case TOK_SEMICOLON: \
+	case TOK_OP_ASSIGN: \
+	case TOK_KW_DO: \
+	case TOK_KW_END: \
+	case TOK_KW_ELIF: \
+	case TOK_KW_ELSE: \
+	case TOK_OP_ASSIGN_ALT: \
+	case TOK_OP_COMPARE: \
+	case TOK_OP_PLUS: \
+	case TOK_OP_MINUS: \
+	case TOK_OP_MULT: \
+	case TOK_OP_DIV: \
+	case TOK_OP_MOD: \
+	case TOK_KW_AND: \
+	case TOK_KW_OR/*:*/
+
+#define ARGS_TAIL_FIRSTS \
+	/*case*/ TOK_COMMA/*:*/
+
+#define ARGS_TAIL_FOLLOWS \
+	/*case*/ TOK_CLOSE_ROUND/*:*/
+
+#endif // LOOKAHEADS_H
@@ -0,0 +1,567 @@
+// Generated by tools/llgen.c from grammar.bnf, do not edit.
+// Included by parser.c, which defines the functions declared below.
+
+#include "common/vector.h"
+#include "frontend/lexical/lexer.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The nonterminals and the hooks of the grammar, numbered after the token
+// types so that a symbol of the grammar fits in a byte.
+typedef enum ll_nonterminal {
+	LL_PROGRAM = TOK_TYPE_COUNT,
+	LL_TOP,
+	LL_ITEM,
+	LL_BLOCK,
+	LL_ITEMS,
+	LL_VAR,
+	LL_STMT_EXPR_TAIL,
+	LL_TYPE,
+	LL_VAR_INIT,
+	LL_EXPR,
+	LL_VAR_EXPR_NEXT,
+	LL_STMT,
+	LL_VAR_STMT_NEXT,
+	LL_TYPE_TAIL,
+	LL_NESTED,
+	LL_STMT_INNER,
+	LL_STMT_EXPR,
+	LL_CONTENT,
+	LL_BODY,
+	LL_ELIF,
+	LL_ATOM,
+	LL_EXPR_TAIL,
+	LL_ATOM_TAIL,
+	LL_ARGS,
+	LL_ARGS_TAIL,
+	LL_NONTERMINAL_END
+} ll_nonterminal_t;
+
+typedef enum ll_hook {
+	LL_HOOK_BLOCK = LL_NONTERMINAL_END,
+	LL_HOOK_COMMIT,
+	LL_HOOK_STRAY,
+	LL_HOOK_DO_BLOCK,
+	LL_HOOK_RESUME,
+	LL_HOOK_VAR_LIST,
+	LL_HOOK_ADD,
+	LL_HOOK_VAR,
+	LL_HOOK_LEFT,
+	LL_HOOK_RIGHT,
+	LL_HOOK_MISSING_STATEMENT,
+	LL_HOOK_NONE,
+	LL_HOOK_TYPE,
+	LL_HOOK_MISSING_TYPE,
+	LL_HOOK_RETURN,
+	LL_HOOK_WHILE,
+	LL_HOOK_IF,
+	LL_HOOK_BRANCH,
+	LL_HOOK_MISSING_CONTENT,
+	LL_HOOK_EXPR,
+	LL_HOOK_EXPR_END,
+	LL_HOOK_INFIX,
+	LL_HOOK_PREFIX,
+	LL_HOOK_LITERAL,
+	LL_HOOK_MISSING_TERM,
+	LL_HOOK_CALL,
+	LL_HOOK_IDENT,
+} ll_hook_t;
+
+#define LL_HOOK_END (LL_HOOK_IDENT + 1)
+
+// Stands for a terminal of several token types, which only ever starts a
+// production so that the table already checked it.
+#define LL_ANY_TOKEN LL_HOOK_END
+typedef char ll_symbols_fit_in_a_byte[LL_ANY_TOKEN < 256 ? 1 : -1];
+
+// The right sides of the productions back to back, each one reversed so
+// that it is pushed onto the stack of the parse loop in order.
+static const uint8_t ll_symbols[] = {
+	/* 1: PROGRAM ::= */ TOK_EOF, LL_HOOK_COMMIT, LL_TOP, LL_HOOK_BLOCK,
+	/* 2: TOP ::= */ LL_TOP, LL_ITEM,
+	/* 3: TOP ::= */ LL_TOP, LL_HOOK_STRAY,
+	/* 4: TOP ::= */
+	/* 5: BLOCK ::= */ LL_HOOK_COMMIT, LL_ITEMS, LL_HOOK_DO_BLOCK,
+	/* 6: ITEMS ::= */ LL_ITEMS, LL_ITEM,
+	/* 7: ITEMS ::= */ LL_ITEMS, LL_HOOK_STRAY,
+	/* 8: ITEMS ::= */
+	/* 9: ITEM ::= */ LL_HOOK_ADD, LL_HOOK_COMMIT, LL_VAR, LL_HOOK_VAR_LIST, TOK_KW_VAR, LL_HOOK_RESUME,
+	/* 10: ITEM ::= */ LL_HOOK_ADD, LL_STMT_EXPR_TAIL, LL_HOOK_RESUME,
+	/* 11: VAR ::= */ LL_VAR_INIT, TOK_OP_ASSIGN, LL_HOOK_LEFT, LL_TYPE, LL_HOOK_VAR, TOK_IDENT,
+	/* 12: VAR_INIT ::= */ LL_VAR_EXPR_NEXT, LL_HOOK_ADD, LL_HOOK_RIGHT, LL_EXPR,
+	/* 13: VAR_INIT ::= */ LL_VAR_STMT_NEXT, LL_HOOK_ADD, LL_HOOK_RIGHT, LL_STMT,
+	/* 14: VAR_INIT ::= */ LL_VAR_STMT_NEXT, LL_HOOK_ADD, LL_HOOK_RIGHT, LL_HOOK_MISSING_STATEMENT,
+	/* 15: VAR_EXPR_NEXT ::= */ LL_VAR, TOK_COMMA,
+	/* 16: VAR_EXPR_NEXT ::= */ TOK_SEMICOLON,
+	/* 17: VAR_EXPR_NEXT ::= */ TOK_SEMICOLON,
+	/* 18: VAR_STMT_NEXT ::= */ LL_VAR, TOK_COMMA,
+	/* 19: VAR_STMT_NEXT ::= */
+	/* 20: TYPE ::= */ LL_TYPE_TAIL, TOK_COLON,
+	/* 21: TYPE ::= */ LL_HOOK_NONE,
+	/* 22: TYPE' ::= */ LL_HOOK_TYPE, TOK_TYPE_NAT,
+	/* 23: TYPE' ::= */ LL_HOOK_TYPE, TOK_TYPE_INT,
+	/* 24: TYPE' ::= */ LL_HOOK_TYPE, TOK_TYPE_BOOL,
+	/* 25: TYPE' ::= */ LL_HOOK_MISSING_TYPE,
+	/* 26: STMT ::= */ LL_HOOK_LEFT, LL_STMT_EXPR_TAIL, LL_HOOK_RETURN, TOK_KW_RETURN,
+	/* 27: STMT ::= */ LL_NESTED,
+	/* 28: STMT_INNER ::= */ LL_HOOK_LEFT, LL_STMT_EXPR, LL_HOOK_RETURN, TOK_KW_RETURN,
+	/* 29: STMT_INNER ::= */ LL_NESTED,
+	/* 30: NESTED ::= */ LL_HOOK_RIGHT, LL_CONTENT, LL_HOOK_LEFT, LL_STMT_EXPR, LL_HOOK_WHILE, TOK_KW_WHILE,
+	/* 31: NESTED ::= */ LL_ELIF, LL_HOOK_ADD, LL_HOOK_RIGHT, LL_BODY, LL_HOOK_LEFT, LL_STMT_EXPR, LL_HOOK_BRANCH, LL_HOOK_IF, TOK_KW_IF,
+	/* 32: NESTED ::= */ TOK_KW_END, LL_BLOCK, TOK_KW_DO,
+	/* 33: CONTENT ::= */ TOK_KW_END, LL_STMT_EXPR, TOK_COLON,
+	/* 34: CONTENT ::= */ TOK_KW_END, LL_BLOCK, TOK_KW_DO,
+	/* 35: CONTENT ::= */ LL_HOOK_MISSING_CONTENT,
+	/* 36: ELIF ::= */ LL_ELIF, LL_HOOK_ADD, LL_HOOK_RIGHT, LL_BODY, LL_HOOK_LEFT, LL_STMT_EXPR, LL_HOOK_BRANCH, TOK_KW_ELIF,
+	/* 37: ELIF ::= */ TOK_KW_END, LL_HOOK_COMMIT, LL_HOOK_ADD, LL_HOOK_RIGHT, LL_BODY, LL_HOOK_BRANCH, TOK_KW_ELSE,
+	/* 38: ELIF ::= */ TOK_KW_END, LL_HOOK_COMMIT,
+	/* 39: ELIF ::= */ TOK_KW_END, LL_HOOK_COMMIT,
+	/* 40: BODY ::= */ LL_STMT_EXPR, TOK_COLON,
+	/* 41: BODY ::= */ LL_BLOCK, TOK_KW_DO,
+	/* 42: BODY ::= */ LL_HOOK_MISSING_CONTENT,
+	/* 43: STMT_EXPR ::= */ LL_STMT_INNER,
+	/* 44: STMT_EXPR ::= */ LL_EXPR,
+	/* 45: STMT_EXPR ::= */ LL_HOOK_MISSING_STATEMENT,
+	/* 46: STMT_EXPR' ::= */ LL_STMT,
+	/* 47: STMT_EXPR' ::= */ TOK_SEMICOLON, LL_EXPR,
+	/* 48: STMT_EXPR' ::= */ LL_HOOK_MISSING_STATEMENT,
+	/* 49: EXPR ::= */ LL_HOOK_EXPR_END, LL_EXPR_TAIL, LL_ATOM, LL_HOOK_EXPR,
+	/* 50: EXPR' ::= */ LL_EXPR_TAIL, LL_ATOM, LL_HOOK_INFIX, LL_ANY_TOKEN,
+	/* 51: EXPR' ::= */
+	/* 52: ATOM ::= */ LL_ATOM, LL_HOOK_PREFIX, LL_ANY_TOKEN,
+	/* 53: ATOM ::= */ TOK_CLOSE_ROUND, LL_EXPR, TOK_OPEN_ROUND,
+	/* 54: ATOM ::= */ LL_ATOM_TAIL, TOK_IDENT,
+	/* 55: ATOM ::= */ LL_HOOK_LITERAL, TOK_LIT_NUM,
+	/* 56: ATOM ::= */ LL_HOOK_LITERAL, TOK_KW_TRUE,
+	/* 57: ATOM ::= */ LL_HOOK_LITERAL, TOK_KW_FALSE,
+	/* 58: ATOM ::= */ LL_HOOK_LITERAL, TOK_KW_NIL,
+	/* 59: ATOM ::= */ LL_HOOK_MISSING_TERM,
+	/* 60: ATOM' ::= */ LL_ARGS, TOK_OPEN_ROUND, LL_HOOK_CALL,
+	/* 61: ATOM' ::= */ LL_HOOK_IDENT,
+	/* 62: ARGS ::= */ TOK_CLOSE_ROUND, LL_HOOK_COMMIT,
+	/* 63: ARGS ::= */ TOK_CLOSE_ROUND, LL_HOOK_COMMIT, LL_ARGS_TAIL, LL_HOOK_ADD, LL_STMT_EXPR,
+	/* 64: ARGS' ::= */ LL_ARGS_TAIL, LL_HOOK_ADD, LL_STMT_EXPR, TOK_COMMA,
+	/* 65: ARGS' ::= */
+};
+
+// Where each production is in `ll_symbols`, production 0 being none.
+static const struct ll_production {
+	uint16_t start;
+	uint8_t length;
+} ll_productions[] = {
+	{0, 0},
+	{0, 4},
+	{4, 2},
+	{6, 2},
+	{8, 0},
+	{8, 3},
+	{11, 2},
+	{13, 2},
+	{15, 0},
+	{15, 6},
+	{21, 3},
+	{24, 6},
+	{30, 4},
+	{34, 4},
+	{38, 4},
+	{42, 2},
+	{44, 1},
+	{45, 1},
+	{46, 2},
+	{48, 0},
+	{48, 2},
+	{50, 1},
+	{51, 2},
+	{53, 2},
+	{55, 2},
+	{57, 1},
+	{58, 4},
+	{62, 1},
+	{63, 4},
+	{67, 1},
+	{68, 6},
+	{74, 9},
+	{83, 3},
+	{86, 3},
+	{89, 3},
+	{92, 1},
+	{93, 8},
+	{101, 7},
+	{108, 2},
+	{110, 2},
+	{112, 2},
+	{114, 2},
+	{116, 1},
+	{117, 1},
+	{118, 1},
+	{119, 1},
+	{120, 1},
+	{121, 2},
+	{123, 1},
+	{124, 4},
+	{128, 4},
+	{132, 0},
+	{132, 3},
+	{135, 3},
+	{138, 2},
+	{140, 2},
+	{142, 2},
+	{144, 2},
+	{146, 2},
+	{148, 1},
+	{149, 3},
+	{152, 1},
+	{153, 2},
+	{155, 5},
+	{160, 4},
+	{164, 0},
+};
+
+// The production of each nonterminal that each token type predicts, 0 for
+// none, and the one each nonterminal falls back on then.
+static const uint8_t ll_predict[LL_NONTERMINAL_END - TOK_TYPE_COUNT][TOK_TYPE_COUNT] = {
+	[LL_PROGRAM - TOK_TYPE_COUNT] = {
+		[TOK_OPEN_ROUND] = 1,
+		[TOK_KW_DO] = 1,
+		[TOK_KW_VAR] = 1,
+		[TOK_KW_RETURN] = 1,
+		[TOK_KW_IF] = 1,
+		[TOK_KW_WHILE] = 1,
+		[TOK_KW_TRUE] = 1,
+		[TOK_KW_FALSE] = 1,
+		[TOK_KW_NIL] = 1,
+		[TOK_IDENT] = 1,
+		[TOK_LIT_NUM] = 1,
+		[TOK_EOF] = 1,
+		[TOK_OP_PLUS] = 1,
+		[TOK_OP_MINUS] = 1,
+		[TOK_KW_NOT] = 1
+	},
+	[LL_TOP - TOK_TYPE_COUNT] = {
+		[TOK_OPEN_ROUND] = 2,
+		[TOK_KW_DO] = 2,
+		[TOK_KW_VAR] = 2,
+		[TOK_KW_RETURN] = 2,
+		[TOK_KW_IF] = 2,
+		[TOK_KW_WHILE] = 2,
+		[TOK_KW_TRUE] = 2,
+		[TOK_KW_FALSE] = 2,
+		[TOK_KW_NIL] = 2,
+		[TOK_IDENT] = 2,
+		[TOK_LIT_NUM] = 2,
+		[TOK_OP_PLUS] = 2,
+		[TOK_OP_MINUS] = 2,
+		[TOK_KW_NOT] = 2,
+		[TOK_EOF] = 4
+	},
+	[LL_ITEM - TOK_TYPE_COUNT] = {
+		[TOK_KW_VAR] = 9,
+		[TOK_OPEN_ROUND] = 10,
+		[TOK_KW_DO] = 10,
+		[TOK_KW_RETURN] = 10,
+		[TOK_KW_IF] = 10,
+		[TOK_KW_WHILE] = 10,
+		[TOK_KW_TRUE] = 10,
+		[TOK_KW_FALSE] = 10,
+		[TOK_KW_NIL] = 10,
+		[TOK_IDENT] = 10,
+		[TOK_LIT_NUM] = 10,
+		[TOK_OP_PLUS] = 10,
+		[TOK_OP_MINUS] = 10,
+		[TOK_KW_NOT] = 10
+	},
+	[LL_BLOCK - TOK_TYPE_COUNT] = {
+		[TOK_OPEN_ROUND] = 5,
+		[TOK_KW_DO] = 5,
+		[TOK_KW_END] = 5,
+		[TOK_KW_VAR] = 5,
+		[TOK_KW_RETURN] = 5,
+		[TOK_KW_IF] = 5,
+		[TOK_KW_ELIF] = 5,
+		[TOK_KW_ELSE] = 5,
+		[TOK_KW_WHILE] = 5,
+		[TOK_KW_TRUE] = 5,
+		[TOK_KW_FALSE] = 5,
+		[TOK_KW_NIL] = 5,
+		[TOK_IDENT] = 5,
+		[TOK_LIT_NUM] = 5,
+		[TOK_EOF] = 5,
+		[TOK_OP_PLUS] = 5,
+		[TOK_OP_MINUS] = 5,
+		[TOK_KW_NOT] = 5
+	},
+	[LL_ITEMS - TOK_TYPE_COUNT] = {
+		[TOK_OPEN_ROUND] = 6,
+		[TOK_KW_DO] = 6,
+		[TOK_KW_VAR] = 6,
+		[TOK_KW_RETURN] = 6,
+		[TOK_KW_IF] = 6,
+		[TOK_KW_WHILE] = 6,
+		[TOK_KW_TRUE] = 6,
+		[TOK_KW_FALSE] = 6,
+		[TOK_KW_NIL] = 6,
+		[TOK_IDENT] = 6,
+		[TOK_LIT_NUM] = 6,
+		[TOK_OP_PLUS] = 6,
+		[TOK_OP_MINUS] = 6,
+		[TOK_KW_NOT] = 6,
+		[TOK_KW_END] = 8,
+		[TOK_KW_ELIF] = 8,
+		[TOK_KW_ELSE] = 8,
+		[TOK_EOF] = 8
+	},
+	[LL_VAR - TOK_TYPE_COUNT] = {
+		[TOK_IDENT] = 11
+	},
+	[LL_STMT_EXPR_TAIL - TOK_TYPE_COUNT] = {
+		[TOK_KW_DO] = 46,
+		[TOK_KW_RETURN] = 46,
+		[TOK_KW_IF] = 46,
+		[TOK_KW_WHILE] = 46,
+		[TOK_OPEN_ROUND] = 47,
+		[TOK_KW_TRUE] = 47,
+		[TOK_KW_FALSE] = 47,
+		[TOK_KW_NIL] = 47,
+		[TOK_IDENT] = 47,
+		[TOK_LIT_NUM] = 47,
+		[TOK_OP_PLUS] = 47,
+		[TOK_OP_MINUS] = 47,
+		[TOK_KW_NOT] = 47
+	},
+	[LL_TYPE - TOK_TYPE_COUNT] = {
+		[TOK_COLON] = 20,
+		[TOK_OP_ASSIGN] = 21,
+		[TOK_EOF] = 21
+	},
+	[LL_VAR_INIT - TOK_TYPE_COUNT] = {
+		[TOK_OPEN_ROUND] = 12,
+		[TOK_KW_TRUE] = 12,
+		[TOK_KW_FALSE] = 12,
+		[TOK_KW_NIL] = 12,
+		[TOK_IDENT] = 12,
+		[TOK_LIT_NUM] = 12,
+		[TOK_OP_PLUS] = 12,
+		[TOK_OP_MINUS] = 12,
+		[TOK_KW_NOT] = 12,
+		[TOK_KW_DO] = 13,
+		[TOK_KW_RETURN] = 13,
+		[TOK_KW_IF] = 13,
+		[TOK_KW_WHILE] = 13
+	},
+	[LL_EXPR - TOK_TYPE_COUNT] = {
+		[TOK_OPEN_ROUND] = 49,
+		[TOK_KW_TRUE] = 49,
+		[TOK_KW_FALSE] = 49,
+		[TOK_KW_NIL] = 49,
+		[TOK_IDENT] = 49,
+		[TOK_LIT_NUM] = 49,
+		[TOK_OP_PLUS] = 49,
+		[TOK_OP_MINUS] = 49,
+		[TOK_KW_NOT] = 49
+	},
+	[LL_VAR_EXPR_NEXT - TOK_TYPE_COUNT] = {
+		[TOK_COMMA] = 15,
+		[TOK_SEMICOLON] = 16
+	},
+	[LL_STMT - TOK_TYPE_COUNT] = {
+		[TOK_KW_RETURN] = 26,
+		[TOK_KW_DO] = 27,
+		[TOK_KW_IF] = 27,
+		[TOK_KW_WHILE] = 27
+	},
+	[LL_VAR_STMT_NEXT - TOK_TYPE_COUNT] = {
+		[TOK_COMMA] = 18,
+		[TOK_OPEN_ROUND] = 19,
+		[TOK_KW_DO] = 19,
+		[TOK_KW_END] = 19,
+		[TOK_KW_VAR] = 19,
+		[TOK_KW_RETURN] = 19,
+		[TOK_KW_IF] = 19,
+		[TOK_KW_ELIF] = 19,
+		[TOK_KW_ELSE] = 19,
+		[TOK_KW_WHILE] = 19,
+		[TOK_KW_TRUE] = 19,
+		[TOK_KW_FALSE] = 19,
+		[TOK_KW_NIL] = 19,
+		[TOK_IDENT] = 19,
+		[TOK_LIT_NUM] = 19,
+		[TOK_EOF] = 19,
+		[TOK_OP_PLUS] = 19,
+		[TOK_OP_MINUS] = 19,
+		[TOK_KW_NOT] = 19
+	},
+	[LL_TYPE_TAIL - TOK_TYPE_COUNT] = {
+		[TOK_TYPE_NAT] = 22,
+		[TOK_TYPE_INT] = 23,
+		[TOK_TYPE_BOOL] = 24
+	},
+	[LL_NESTED - TOK_TYPE_COUNT] = {
+		[TOK_KW_WHILE] = 30,
+		[TOK_KW_IF] = 31,
+		[TOK_KW_DO] = 32
+	},
+	[LL_STMT_INNER - TOK_TYPE_COUNT] = {
+		[TOK_KW_RETURN] = 28,
+		[TOK_KW_DO] = 29,
+		[TOK_KW_IF] = 29,
+		[TOK_KW_WHILE] = 29
+	},
+	[LL_STMT_EXPR - TOK_TYPE_COUNT] = {
+		[TOK_KW_DO] = 43,
+		[TOK_KW_RETURN] = 43,
+		[TOK_KW_IF] = 43,
+		[TOK_KW_WHILE] = 43,
+		[TOK_OPEN_ROUND] = 44,
+		[TOK_KW_TRUE] = 44,
+		[TOK_KW_FALSE] = 44,
+		[TOK_KW_NIL] = 44,
+		[TOK_IDENT] = 44,
+		[TOK_LIT_NUM] = 44,
+		[TOK_OP_PLUS] = 44,
+		[TOK_OP_MINUS] = 44,
+		[TOK_KW_NOT] = 44
+	},
+	[LL_CONTENT - TOK_TYPE_COUNT] = {
+		[TOK_COLON] = 33,
+		[TOK_KW_DO] = 34
+	},
+	[LL_BODY - TOK_TYPE_COUNT] = {
+		[TOK_COLON] = 40,
+		[TOK_KW_DO] = 41
+	},
+	[LL_ELIF - TOK_TYPE_COUNT] = {
+		[TOK_KW_ELIF] = 36,
+		[TOK_KW_ELSE] = 37,
+		[TOK_KW_END] = 38
+	},
+	[LL_ATOM - TOK_TYPE_COUNT] = {
+		[TOK_OP_PLUS] = 52,
+		[TOK_OP_MINUS] = 52,
+		[TOK_KW_NOT] = 52,
+		[TOK_OPEN_ROUND] = 53,
+		[TOK_IDENT] = 54,
+		[TOK_LIT_NUM] = 55,
+		[TOK_KW_TRUE] = 56,
+		[TOK_KW_FALSE] = 57,
+		[TOK_KW_NIL] = 58
+	},
+	[LL_EXPR_TAIL - TOK_TYPE_COUNT] = {
+		[TOK_OP_ASSIGN] = 50,
+		[TOK_OP_ASSIGN_ALT] = 50,
+		[TOK_OP_COMPARE] = 50,
+		[TOK_OP_PLUS] = 50,
+		[TOK_OP_MINUS] = 50,
+		[TOK_OP_MULT] = 50,
+		[TOK_OP_DIV] = 50,
+		[TOK_OP_MOD] = 50,
+		[TOK_KW_AND] = 50,
+		[TOK_KW_OR] = 50,
+		[TOK_CLOSE_ROUND] = 51,
+		[TOK_COMMA] = 51,
+		[TOK_COLON] = 51,
+		[TOK_SEMICOLON] = 51,
+		[TOK_KW_DO] = 51,
+		[TOK_KW_END] = 51,
+		[TOK_KW_ELIF] = 51,
+		[TOK_KW_ELSE] = 51,
+		[TOK_EOF] = 51
+	},
+	[LL_ATOM_TAIL - TOK_TYPE_COUNT] = {
+		[TOK_OPEN_ROUND] = 60,
+		[TOK_CLOSE_ROUND] = 61,
+		[TOK_COMMA] = 61,
+		[TOK_COLON] = 61,
+		[TOK_SEMICOLON] = 61,
+		[TOK_OP_ASSIGN] = 61,
+		[TOK_KW_DO] = 61,
+		[TOK_KW_END] = 61,
+		[TOK_KW_ELIF] = 61,
+		[TOK_KW_ELSE] = 61,
+		[TOK_EOF] = 61,
+		[TOK_OP_ASSIGN_ALT] = 61,
+		[TOK_OP_COMPARE] = 61,
+		[TOK_OP_PLUS] = 61,
+		[TOK_OP_MINUS] = 61,
+		[TOK_OP_MULT] = 61,
+		[TOK_OP_DIV] = 61,
+		[TOK_OP_MOD] = 61,
+		[TOK_KW_AND] = 61,
+		[TOK_KW_OR] = 61
+	},
+	[LL_ARGS - TOK_TYPE_COUNT] = {
+		[TOK_CLOSE_ROUND] = 62
+	},
+	[LL_ARGS_TAIL - TOK_TYPE_COUNT] = {
+		[TOK_COMMA] = 64,
+		[TOK_CLOSE_ROUND] = 65,
+		[TOK_EOF] = 65
+	},
+};
+
+static const uint8_t ll_fallbacks[LL_NONTERMINAL_END - TOK_TYPE_COUNT] = {
+	[LL_PROGRAM - TOK_TYPE_COUNT] = 1,
+	[LL_TOP - TOK_TYPE_COUNT] = 3,
+	[LL_ITEM - TOK_TYPE_COUNT] = 0,
+	[LL_BLOCK - TOK_TYPE_COUNT] = 5,
+	[LL_ITEMS - TOK_TYPE_COUNT] = 7,
+	[LL_VAR - TOK_TYPE_COUNT] = 11,
+	[LL_STMT_EXPR_TAIL - TOK_TYPE_COUNT] = 48,
+	[LL_TYPE - TOK_TYPE_COUNT] = 21,
+	[LL_VAR_INIT - TOK_TYPE_COUNT] = 14,
+	[LL_EXPR - TOK_TYPE_COUNT] = 49,
+	[LL_VAR_EXPR_NEXT - TOK_TYPE_COUNT] = 17,
+	[LL_STMT - TOK_TYPE_COUNT] = 0,
+	[LL_VAR_STMT_NEXT - TOK_TYPE_COUNT] = 19,
+	[LL_TYPE_TAIL - TOK_TYPE_COUNT] = 25,
+	[LL_NESTED - TOK_TYPE_COUNT] = 0,
+	[LL_STMT_INNER - TOK_TYPE_COUNT] = 0,
+	[LL_STMT_EXPR - TOK_TYPE_COUNT] = 45,
+	[LL_CONTENT - TOK_TYPE_COUNT] = 35,
+	[LL_BODY - TOK_TYPE_COUNT] = 42,
+	[LL_ELIF - TOK_TYPE_COUNT] = 39,
+	[LL_ATOM - TOK_TYPE_COUNT] = 59,
+	[LL_EXPR_TAIL - TOK_TYPE_COUNT] = 51,
+	[LL_ATOM_TAIL - TOK_TYPE_COUNT] = 61,
+	[LL_ARGS - TOK_TYPE_COUNT] = 63,
+	[LL_ARGS_TAIL - TOK_TYPE_COUNT] = 65,
+};
+
+VECTOR_DEFINE(ll_stack, uint8_t)
+
+struct parser;
+static token_type_t ll_peek(struct parser *ps);
+static void ll_match(struct parser *ps, token_type_t type);
+static void ll_match_any(struct parser *ps);
+static void ll_hook(struct parser *ps, ll_hook_t hook);
+
+/** Parses what a nonterminal derives to, picking its productions by the
+  * next token. The symbols still to parse wait on a stack rather than on
+  * the C stack, so there is no limit to how deep the input can nest.
+  * @param stack Where to keep the symbols, which is left as it was found.
+  */
+static void ll_parse(struct parser *ps, ll_stack_t *stack, ll_nonterminal_t start) {
+	size_t base = stack->count;
+	ll_stack_push(stack, (uint8_t) start);
+	// Kept out of the vector while the hooks run, its bytes could be any of
+	// the memory they write to as far as the compiler knows
+	size_t count = stack->count;
+	while(count > base) {
+		uint8_t symbol = stack->data[--count];
+		if(symbol < TOK_TYPE_COUNT) ll_match(ps, (token_type_t) symbol);
+		else if(symbol < LL_NONTERMINAL_END) {
+			size_t row = symbol - TOK_TYPE_COUNT;
+			uint8_t production = ll_predict[row][ll_peek(ps)];
+			if(production == 0) production = ll_fallbacks[row];
+			assert(production != 0);
+			const struct ll_production *rhs = &ll_productions[production];
+			stack->count = count;
+			for(size_t i=rhs->start; i<rhs->start + rhs->length; i++)
+				ll_stack_push(stack, ll_symbols[i]);
+			count = stack->count;
+		} else if(symbol < LL_HOOK_END) ll_hook(ps, (ll_hook_t) symbol);
+		else ll_match_any(ps);
+	}
+	stack->count = count;
+}
@@ -3,9 +3,10 @@
 function build {
 	case $1 in
 		# So far the minimum viable standard is C99
-		"release") GCC_ARGS="-Wall -Wextra -Werror -pedantic --std=c99 -O2" ;;
-		"debug") GCC_ARGS="-Wall -Wextra -pedantic --std=c99 -g" ;;
+		"release") GCC_ARGS="-Wall -Wextra -Werror -pedantic --std=c99 -O2 -pthread" ;;
+		"debug") GCC_ARGS="-Wall -Wextra -pedantic --std=c99 -g -pthread" ;;
 	esac
+	generate
 	build_rec 'src'
 	binfiles=$(find 'bin' -maxdepth 1 -mindepth 1 -type f -name "*.o")
 	binfiles=$(echo "$binfiles" | tr '\n' ' ')
@@ -13,6 +14,18 @@ function build {
 	gcc $GCC_ARGS -o bin/compiler $binfiles
 }
 
+function generate {
+	# Build the generator tools and run them before anything depends on them
+	mkdir -p 'bin/tools' 'bin/gen/frontend/lexical' 'bin/gen/frontend/syntactic'
+	echo "Generating: tools/keygen.c -> bin/gen/frontend/lexical/keywords.c"
+	gcc $GCC_ARGS -o bin/tools/keygen tools/keygen.c -Iincl || exit 1
+	bin/tools/keygen bin/gen/frontend/lexical/keywords.c || exit 1
+	echo "Generating: tools/llgen.c grammar.bnf -> bin/gen/frontend/syntactic/{lookaheads.h,parse_table.c}"
+	gcc $GCC_ARGS -o bin/tools/llgen tools/llgen.c || exit 1
+	bin/tools/llgen grammar.bnf bin/gen/frontend/syntactic/lookaheads.h \
+		bin/gen/frontend/syntactic/parse_table.c || exit 1
+}
+
 function build_rec {
 	local incldir=$(echo "$1" | sed -e 's/src/incl/')
 	local bindir=$(echo "$1" | sed -e 's/src/bin/')
@@ -25,7 +38,7 @@ function build_rec {
 		
 		mkdir -p "$bindir"
 		echo "Building: $srcfile -> $binfile"
-		gcc $GCC_ARGS -c -o "$binfile" $srcfile -Iincl -I"$incldir"
+		gcc $GCC_ARGS -c -o "$binfile" $srcfile -Iincl -I"$incldir" -Ibin/gen
 	done
 
 	# Recurse for all subdirectories and then merge generated object files
@@ -40,6 +53,55 @@ function build_rec {
 	done
 }
 
+function json_value {
+	# Good enough for the flat numbers of the stats report
+	echo "$1" | grep -o "\"$2\":[0-9.]*" | head -n 1 | cut -d':' -f2
+}
+
+function bench {
+	# Runs every phase on programs of each shape made by bench/gen.c and
+	# prints one tab separated row per shape and phase. The time is the best
+	# of a few runs. Lexing is measured in MB/s, the later phases in nodes/s.
+	local size=${1:-4M} runs=${2:-3}
+	build release > /dev/null
+	[[ -x bin/compiler ]] || exit 1
+	mkdir -p 'bin/bench'
+	gcc $GCC_ARGS -o bin/bench/gen bench/gen.c || exit 1
+
+	printf "shape\tphase\tbytes\ttokens\tnodes\tms\tmb_per_s\tnodes_per_s\tpeak_rss_kib\n"
+	for shape in vars exprs nesting deep comments literals; do
+		local input="bin/bench/$shape.txt"
+		bin/bench/gen $shape $size $input || exit 1
+		for phase in lex parse sema ir; do
+			local best="" best_stats=""
+			for ((run = 0; run < runs; run++)); do
+				# A program with errors stops short of the phase, timing nothing
+				local stats
+				if ! stats=$(bin/compiler --stop-after=$phase --stats=json $input 2>&1 > /dev/null); then
+					echo "bench: $input does not compile past $phase" >&2
+					exit 1
+				fi
+				local time=$(json_value "$stats" $phase)
+				if [[ -z $best ]] || awk "BEGIN { exit !($time < $best) }"; then
+					best=$time best_stats=$stats
+				fi
+			done
+
+			local bytes=$(json_value "$best_stats" bytes)
+			local tokens=$(json_value "$best_stats" tokens)
+			local nodes=$(json_value "$best_stats" total)
+			local rss=$(json_value "$best_stats" peak_rss_kib)
+			awk -v shape=$shape -v phase=$phase -v bytes=$bytes -v tokens=$tokens \
+				-v nodes=$nodes -v ms=$best -v rss=$rss 'BEGIN {
+				seconds = (ms > 0 ? ms : 0.001) / 1000
+				rate = phase == "lex" ? "-" : sprintf("%.0f", nodes / seconds)
+				printf "%s\t%s\t%d\t%d\t%d\t%.3f\t%.2f\t%s\t%d\n", shape, phase,
+					bytes, tokens, nodes, ms, bytes / seconds / 1e6, rate, rss
+			}'
+		done
+	done
+}
+
 function clean {
 	[[ -d bin/ ]] && rm -r bin/
 	return 0
@@ -47,5 +109,6 @@ function clean {
 
 case $1 in
 	"build") build $2 ;;
+	"bench") bench $2 $3 ;;
 	"clean") clean ;;
 esac
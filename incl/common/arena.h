@@ -5,6 +5,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// The alignment of blocks allocated with `arena_alloc`.
+#define ARENA_DEFAULT_ALIGN sizeof(uintptr_t)
+
+// The size after which regions stop growing geometrically.
+#define ARENA_MAX_GROWTH (64 * 1024 * 1024)
+
 /** Dynamically sized struct encompassing a block of allocatable space by the
   * arena. The arena itself is a collection of these regions arranged into a
   * singly-linked list.
@@ -12,12 +18,12 @@
 typedef struct region {
 	/// Pointer to the next region in the linked list or `NULL` if last.
 	struct region *next;
-	/// Count of how many elements are allocated from the `data` array.
+	/// Count of how many bytes are allocated from the `data` array.
 	size_t used;
-	/// Count of homw many elements can maximally fit in the `data` array.
+	/// Count of how many bytes can maximally fit in the `data` array.
 	size_t size;
-	/// A dynamic array of elements representing the allocatable space.
-	uintptr_t data[];
+	/// A dynamic array of bytes representing the allocatable space.
+	uint8_t data[];
 } region_t;
 
 /** Struct representing an arena. All functions that opererate on arenas
@@ -27,43 +33,126 @@ typedef struct region {
 typedef struct arena {
 	/// Allocations that create a new region use this value as its minimum size.
 	size_t min_region_size;
+	/// Whether allocated blocks are guaranteed to be zeroed.
+	bool zeroed;
 	/// Pointer to the first region in the linked list of regions.
 	region_t *first;
 	/// Pointer to the last region that contains allocations.
 	region_t *last;
+	/// The `arena_requested` and `arena_wasted` of the arena, kept here so
+	/// that the fast path stays clear of the thread's stats and added to
+	/// them once when the arena is freed.
+	size_t requested;
+	size_t wasted;
 } arena_t;
 
+/** A snapshot of how much of an arena is allocated, taken with `arena_mark`
+  * to later free every allocation made after it with `arena_reset_to`.
+  */
+typedef struct arena_mark {
+	/// The region that was last when the mark was taken or `NULL` if none.
+	region_t *region;
+	/// How many bytes of `region` were allocated when the mark was taken.
+	size_t used;
+} arena_mark_t;
+
 /** Creates a new empty `arena_t` struct. No regions are allocated initially.
   * An arena is a supplemental allocation scheme ontop of `malloc` that allows
   * allocations with a similar purpose to be grouped together and deallocated
   * all at once when their need expires. This implementation specifically uses
   * the very simple bump allocator which does not allow freeing of elements at
-  * the middle of an allocated space.
+  * the middle of an allocated space. Blocks allocated from it are zeroed.
   * @param min_region_size_bytes The minimum size that regions of this arena
-  * will be allocated to be. Internally rounded to the next higher multiple of
-  * the size of `uintptr_t`. Set this to a lower value if you expect big and
-  * small element allocations intermixed and to a higher value if you expect a
-  * more uniform allocation size.
+  * will be allocated to be. Regions grow geometrically past this size. Set
+  * this to a lower value if you expect few allocations and to a higher value
+  * if you expect many.
   * @return The newly created `arena_t` struct.
   */
 arena_t arena_new(size_t min_region_size_bytes);
 
-/** Attempts to allocate a block of memory to an arena using a constant time
-  * complexity bump allocator. The `last` field in the `arena` struct is used
-  * as the starting point for the lookup of viable allocation space. If the
-  * last region is reached but no space has been found a new region is created.
+/** Same as `arena_new` except that the blocks allocated from the arena are
+  * left uninitialized, which saves clearing regions that will be overwritten.
+  * @param min_region_size_bytes The minimum size that regions will be.
+  * @return The newly created `arena_t` struct.
+  */
+arena_t arena_new_raw(size_t min_region_size_bytes);
+
+/** The slow path of `arena_alloc_aligned`, taken when the block does not fit
+  * in the last region. Moves on to the next region if it already exists and
+  * the block fits, otherwise creates a new one after the last region.
+  */
+void *arena_alloc_slow(arena_t *arena, size_t block_size_bytes, size_t alignment);
+
+/** Allocates a block of memory from an arena using a constant time bump
+  * allocator. Only the last region of the arena is considered, the slow
+  * path is taken if the block does not fit in it.
   * @param arena The arena to allocate the block into.
   * @param block_size_bytes The amount of bytes the new block will be.
-  * Rounded up to a multiple of the size of `uintptr_t`.
+  * @param alignment The alignment of the block. Must be a power of two.
   * @return The address of the newly allocated block or `NULL` if during the
   * process there was a need to allocate a new region and `malloc` returned
   * `NULL`.
   */
-void *arena_alloc(arena_t *arena, size_t block_size_bytes);
+static inline void *arena_alloc_aligned(arena_t *arena, size_t block_size_bytes, size_t alignment) {
+	region_t *region = arena->last;
+	if(region != NULL) {
+		uintptr_t next = (uintptr_t) &region->data[region->used];
+		size_t padding = (size_t) (-next & (alignment - 1));
+		if(padding + block_size_bytes <= region->size - region->used) {
+			region->used += padding + block_size_bytes;
+			arena->requested += block_size_bytes;
+			arena->wasted += padding;
+			return (void *) (next + padding);
+		}
+	}
+	return arena_alloc_slow(arena, block_size_bytes, alignment);
+}
+
+/** Allocates a block of memory from an arena, aligned to the size of
+  * `uintptr_t`. See `arena_alloc_aligned` for the details.
+  * @param arena The arena to allocate the block into.
+  * @param block_size_bytes The amount of bytes the new block will be.
+  * @return The address of the newly allocated block or `NULL` on failure.
+  */
+static inline void *arena_alloc(arena_t *arena, size_t block_size_bytes) {
+	return arena_alloc_aligned(arena, block_size_bytes, ARENA_DEFAULT_ALIGN);
+}
+
+/** Attempts to grow a block in place, which is only possible when it is the
+  * most recent allocation of the arena and its region has enough room left.
+  * @param arena The arena the block was allocated from.
+  * @param block The block to grow.
+  * @param old_size_bytes The size the block was allocated or last grown to.
+  * @param new_size_bytes The size to grow the block to.
+  * @return Whether the block was grown. If not the block is left untouched.
+  */
+bool arena_extend(arena_t *arena, void *block, size_t old_size_bytes, size_t new_size_bytes);
+
+/** Checks whether a pointer points inside one of the regions of an arena.
+  * Walks all the regions so it is only meant for uncommon paths.
+  * @param arena The arena to look in.
+  * @param pointer The pointer to look for.
+  * @return Whether the pointer is in the arena.
+  */
+bool arena_owns(const arena_t *arena, const void *pointer);
+
+/** Takes a snapshot of the allocations of an arena.
+  * @param arena The arena to take a snapshot of.
+  * @return The mark to pass to `arena_reset_to`.
+  */
+arena_mark_t arena_mark(arena_t *arena);
+
+/** Frees every allocation made from the arena after the given mark was taken.
+  * The regions are kept around to be reused by later allocations.
+  * @param arena The arena the mark was taken from.
+  * @param mark The mark to return to. Marks taken after it become invalid.
+  */
+void arena_reset_to(arena_t *arena, arena_mark_t mark);
 
 /** Clears the arena of all allocations and removes and `free`s all of its
   * regions. The arena is ultimately left to a state equivalent to if it was
-  * just created with `arena_new`.
+  * just created with `arena_new`. Its counters go to the stats of the
+  * calling thread.
   * @param arena The arena to clear all allocations from.
   */
 void arena_free(arena_t *arena);
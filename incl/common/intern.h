@@ -0,0 +1,59 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include "arena.h"
+#include "strslice.h"
+#include "vector.h"
+
+#include <stdint.h>
+
+/// A dense integer that uniquely identifies a distinct interned string.
+typedef uint32_t symbol_t;
+
+// The symbol of tokens and nodes that do not carry a name.
+#define NO_SYMBOL UINT32_MAX
+
+VECTOR_DEFINE(string_list, string_t)
+
+/** A hash-consing table that maps every distinct string given to it to a
+  * `symbol_t`, assigned in order of first appearance starting from zero, so
+  * that equal strings can be compared and used to index arrays as integers.
+  * The strings are not copied and must outlive the table. The hash table
+  * comes from its own arena, the list of strings is on the heap so that the
+  * table can be moved around by value.
+  */
+typedef struct intern {
+	arena_t arena;
+	/// Open-addressing hash table of `symbol_t + 1` values, 0 when empty.
+	uint32_t *slots;
+	/// The hash of the string in each slot, to skip most comparisons.
+	uint32_t *hashes;
+	/// The amount of slots, always a power of two.
+	size_t capacity;
+	/// The string of every symbol, indexed by the symbol.
+	string_list_t strings;
+} intern_t;
+
+/** Creates a new empty interning table.
+  * @return The newly created table, to be freed with `intern_free`.
+  */
+intern_t intern_new(void);
+
+/** Looks up the symbol of a string, assigning a new one if it is the first
+  * time the string has been seen.
+  * @param table The table to look the string up in.
+  * @param string The string to intern. Must outlive the table.
+  * @return The symbol of the string.
+  */
+symbol_t intern_get(intern_t *table, string_t string);
+
+/// Returns the string a symbol was assigned to.
+string_t intern_string(const intern_t *table, symbol_t symbol);
+
+/// Returns the amount of symbols assigned so far.
+size_t intern_count(const intern_t *table);
+
+/// Frees all memory used by the table.
+void intern_free(intern_t *table);
+
+#endif // INTERN_H
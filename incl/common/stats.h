@@ -0,0 +1,35 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+
+/** Counters kept by the memory utilities over the whole run, separately for
+  * each thread. They are only ever added to, so taking the difference of two
+  * snapshots gives the activity of the thread in between. A thread that
+  * works for another has to hand its difference over to be counted.
+  */
+typedef struct memory_stats {
+	/// Bytes asked for from arenas, by allocations and in place growths.
+	size_t arena_requested;
+	/// Bytes of regions arenas got from `malloc`.
+	size_t arena_reserved;
+	/// Regions arenas got from `malloc`.
+	size_t arena_regions;
+	/// Bytes lost to alignment padding, to the unused ends of regions that
+	/// were moved on from and to blocks abandoned by growing containers.
+	size_t arena_wasted;
+	/// Times a vector ran out of room and had to grow.
+	size_t vector_regrowths;
+	/// How many of those growths extended the storage without moving it.
+	size_t vector_regrowths_in_place;
+} memory_stats_t;
+
+/** Returns the counters of the calling thread, which start out at zero the
+  * first time a thread asks for them. They are freed when the thread exits.
+  */
+memory_stats_t *memory_stats_local(void);
+
+/// Adds the activity between two snapshots to a running total.
+void memory_stats_accumulate(memory_stats_t *total, const memory_stats_t *before, const memory_stats_t *after);
+
+#endif // STATS_H
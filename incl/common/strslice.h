@@ -1,6 +1,7 @@
 #ifndef STRSLICE_H
 #define STRSLICE_H
 
+#include <stdbool.h>
 #include <stdio.h>
 
 /** A general-usage string slice. The string is said to be empty when `string`
@@ -28,28 +29,75 @@ typedef struct string {
 // Convenience macro to construct a string without the use of a struct literal.
 #define CONSTRUCT_STR(m_size, m_string) ((string_t){.size=m_size, .string=m_string})
 
-/** A struct to represent a file that has been read into memory.
-  * TODO: Better description here.
+// The amount of zeroed bytes guaranteed to be readable past the end of the
+// contents of a file loaded with `str_file_load` or a string from `str_read`.
+#define STR_PADDING 64
+
+/** A struct to represent a file that has been read into memory. The contents
+  * are either a read-only memory mapping of the file or, when the file cannot
+  * be mapped (pipes, terminals, empty files), a heap-allocated copy of it. In
+  * both cases the contents are followed by a null terminator which is counted
+  * in the size of `content`, and then by at least `STR_PADDING` zeroed bytes.
   */
 typedef struct string_file {
 	/// Absolute or relative path to the file whose contents are in `content`.
 	string_t name;
 	/// The contents of the file that where read into memory or `EMPTY_STRING`
-	/// if the file is yet to be read. Nominally heap-allocated.
+	/// if the file is yet to be read. Must not be written to.
 	string_t content;
 	// The amount of lines the file contains.
 	unsigned lines;
+	/// Offsets into `content` at which each of the `lines` lines starts.
+	size_t *line_starts;
+	/// Whether `content` is a memory mapping rather than a heap allocation.
+	bool mapped;
+	/// The size in bytes of the memory backing `content`, padding included.
+	size_t reserved;
 } string_file_t;
 
-/** Attempts to read from the given file in chunks and allocates an array on
-  * the heap to exatly fit the contents of it. If allocation is unsuccessful
-  * then an empty string is returned instead and errno is set. Use `error_if`
-  * to report the error and exit or handle it.
+/** Attempts to read from the given file directly into a heap-allocated
+  * array which is grown geometrically until the end of the file is reached.
+  * The contents are null-terminated and followed by `STR_PADDING` zeroed
+  * bytes. If allocation is unsuccessful then an empty string is returned
+  * instead and errno is set. Use `error_if` to report the error and exit or
+  * handle it.
   * @param fdesc The opened file descriptor to read from.
   * @return Returns a string struct with heap-allocated data if successful.
   */
 string_t str_read(FILE *fdesc);
 
-unsigned str_count_lines(string_t string);
+/** Loads the file at the given path into memory. Regular files are mapped
+  * read-only without copying while anything else falls back to `str_read`.
+  * The offsets at which each line starts are indexed as part of loading.
+  * The path "-" refers to the standard input. On failure the returned file
+  * has an empty `content` and errno is set. Use `error_if` to report the error
+  * and exit or handle it.
+  * @param path The path to the file to load. Must outlive the returned struct.
+  * @return The loaded file, to be released with `str_file_free`.
+  */
+string_file_t str_file_load(const char *path);
+
+/** Releases the contents of a file loaded with `str_file_load` and leaves its
+  * `content` empty.
+  * @param file The file to release the contents of.
+  */
+void str_file_free(string_file_t *file);
+
+
+/** Finds the zero-based line and column at which a position within the
+  * contents of a file lies, using a binary search over its line index.
+  * @param file The file whose contents `spot` points into.
+  * @param spot The position to locate.
+  * @param row Set to the line `spot` lies in.
+  * @param column Set to the offset of `spot` from the start of that line.
+  */
+void str_file_locate(const string_file_t *file, const char *spot, unsigned *row, unsigned *column);
+
+/** Fetches the contents of a line of a file, excluding the line break.
+  * @param file The file to fetch the line from.
+  * @param row The zero-based index of the line.
+  * @return The line or `EMPTY_STRING` if it is out of bounds.
+  */
+string_t str_file_get_line(const string_file_t *file, unsigned row);
 
 #endif // STRSLICE_H
@@ -3,6 +3,7 @@
 
 #include "arena.h"
 
+#include <assert.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -24,4 +25,78 @@ void vector_add_to(vector_t **vector, const void *data, size_t index);
 void vector_take_from(vector_t *vector, void *data, size_t index);
 void *vector_peek_from(vector_t *vector, size_t index);
 
+/** Resizes the storage of a typed vector. Storage in an arena is grown in
+  * place when it is the most recent allocation of the arena, otherwise it is
+  * copied into a new block and the old one is abandoned. Storage on the heap
+  * is `realloc`ed.
+  * @param arena The arena the storage belongs to or `NULL` for the heap.
+  * @param data The current storage or `NULL` if there is none yet.
+  * @param old_capacity The amount of elements `data` has room for.
+  * @param new_capacity The amount of elements to make room for.
+  * @param unit_size The size of each element in bytes.
+  * @return The resized storage.
+  */
+void *vector_reserve(arena_t *arena, void *data, size_t old_capacity, size_t new_capacity, size_t unit_size);
+
+/** Defines `name_t`, a vector of elements of type `T`, along with inlined
+  * functions to operate on it, all prefixed with `name_`. Unlike `vector_t`
+  * the header is separate from the elements so growing never moves it.
+  * - `name_new(arena, capacity)` makes an empty vector, on the heap if
+  * `arena` is `NULL`. Heap vectors are released with `name_free`.
+  * - `name_from(arena, buffer, capacity)` makes an empty vector that starts
+  * out in the given buffer, such as an array on the C stack, and spills into
+  * `arena` when that is outgrown.
+  * - `name_push`, `name_pop` and `name_peek` operate on the end of the vector.
+  * - `name_at` returns a pointer to an element or `NULL` if out of bounds.
+  */
+#define VECTOR_DEFINE(name, T) \
+	typedef struct name { \
+		arena_t *arena; \
+		T *data; \
+		size_t count; \
+		size_t capacity; \
+	} name##_t; \
+	\
+	static inline name##_t name##_new(arena_t *arena, size_t capacity) { \
+		name##_t vector = {.arena = arena, .data = NULL, .count = 0, .capacity = capacity}; \
+		if(capacity > 0) vector.data = (T *) vector_reserve(arena, NULL, 0, capacity, sizeof(T)); \
+		return vector; \
+	} \
+	\
+	static inline name##_t name##_from(arena_t *arena, T *buffer, size_t capacity) { \
+		assert(arena != NULL); \
+		return (name##_t) {.arena = arena, .data = buffer, .count = 0, .capacity = capacity}; \
+	} \
+	\
+	static inline void name##_push(name##_t *vector, T item) { \
+		if(vector->count == vector->capacity) { \
+			size_t new_capacity = vector->capacity < 4 ? 8 : vector->capacity * 2; \
+			vector->data = (T *) vector_reserve(vector->arena, vector->data, \
+				vector->capacity, new_capacity, sizeof(T)); \
+			vector->capacity = new_capacity; \
+		} \
+		vector->data[vector->count++] = item; \
+	} \
+	\
+	static inline T name##_pop(name##_t *vector) { \
+		assert(vector->count > 0); \
+		return vector->data[--vector->count]; \
+	} \
+	\
+	static inline T *name##_peek(name##_t *vector) { \
+		if(vector->count == 0) return NULL; \
+		return &vector->data[vector->count - 1]; \
+	} \
+	\
+	static inline T *name##_at(name##_t *vector, size_t index) { \
+		if(index >= vector->count) return NULL; \
+		return &vector->data[index]; \
+	} \
+	\
+	static inline void name##_free(name##_t *vector) { \
+		if(vector->arena == NULL) free(vector->data); \
+		vector->data = NULL; \
+		vector->count = vector->capacity = 0; \
+	}
+
 #endif // VECTOR_H
@@ -3,8 +3,11 @@
 
 #include "common/arena.h"
 #include "common/strslice.h"
+#include "common/vector.h"
 
+#include <setjmp.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 #define LINE_SPAN 1
 
@@ -24,12 +27,44 @@ typedef struct error {
 	string_t message;
 } error_t;
 
-void err_init(void);
-arena_t *err_get_arena(void);
+VECTOR_DEFINE(error_list, error_t)
+
+/** Collects the errors reported while compiling a single file. Every file
+  * has its own so that files can be compiled independently of each other.
+  * Must not be moved once initialized as its list lives in its arena.
+  */
+typedef struct error_sink {
+	/// Holds the errors and anything their messages need to allocate.
+	arena_t arena;
+	error_list_t errors;
+	/// Where fatal errors jump to, if anywhere.
+	jmp_buf *bail;
+	/// Whether a fatal error was submitted.
+	bool fatal;
+	/// How many errors are kept before giving up on the file, 0 for no limit.
+	size_t limit;
+} error_sink_t;
+
+void err_init(error_sink_t *sink);
+arena_t *err_get_arena(error_sink_t *sink);
 
 error_t err_new(string_file_t file, string_t spot, string_t message);
-void err_submit(error_t error, bool fatal);
-void err_finalize(void);
+/** Adds an error to the sink. Fatal errors stop the compilation of the file
+  * by jumping to the `bail` buffer of the sink if one is set, otherwise the
+  * caller is expected to check `fatal` and stop on its own. Reaching the
+  * limit of the sink is fatal and any error past it is dropped.
+  * @param sink The sink to add the error to.
+  * @param error The error to add.
+  * @param fatal Whether compiling the file can not go on after the error.
+  */
+void err_submit(error_sink_t *sink, error_t error, bool fatal);
+/// Returns how many errors were submitted since `err_init`.
+size_t err_count(const error_sink_t *sink);
+/// Whether the sink reached its limit, so that any further error is dropped.
+bool err_full(const error_sink_t *sink);
+/// Writes out all errors of the sink in the order they appear in the file and
+/// frees it. Errors on the same spot keep the order they were submitted in.
+void err_finalize(error_sink_t *sink, FILE *stream);
 
 /** Prints the last error code with perror and exits with
   * EXIT_FAILURE if the given boolean is true.
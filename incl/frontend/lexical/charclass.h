@@ -0,0 +1,22 @@
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+#include <stdint.h>
+
+/** Bit flags describing which lexical categories a character belongs to.
+  * Unlike the functions of `ctype.h` these do not depend on the locale.
+  */
+typedef enum char_class {
+	CHAR_IDENT_START = 1 << 0,
+	CHAR_IDENT_PART = 1 << 1,
+	CHAR_DIGIT = 1 << 2,
+	CHAR_WHITE_SPACE = 1 << 3,
+	CHAR_SYMBOL = 1 << 4
+} char_class_t;
+
+extern const uint8_t char_classes[256];
+
+// Checks whether a character belongs to any of the given classes.
+#define char_is(c, classes) (char_classes[(uint8_t) (c)] & (classes))
+
+#endif // CHARCLASS_H
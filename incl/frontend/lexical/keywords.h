@@ -0,0 +1,17 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+// The reserved words of the language paired with the token type they are
+// lexed into, without its "TOK_" prefix. The keyword lookup table used by
+// the lexer is generated from this list at build time by `tools/keygen.c`.
+#define FOREACH_KEYWORD(FN) \
+	FN(do, KW_DO) FN(end, KW_END) FN(var, KW_VAR) FN(return, KW_RETURN) \
+	FN(if, KW_IF) FN(elif, KW_ELIF) FN(else, KW_ELSE) FN(while, KW_WHILE) \
+	FN(and, KW_AND) FN(or, KW_OR) FN(not, KW_NOT) \
+	FN(true, KW_TRUE) FN(false, KW_FALSE) FN(nil, KW_NIL) \
+	FN(nat, TYPE_NAT) FN(int, TYPE_INT) FN(bool, TYPE_BOOL)
+
+// Keywords are compared as a single 64-bit word so none may be any longer.
+#define KEYWORD_MAX_LENGTH 8
+
+#endif // KEYWORDS_H
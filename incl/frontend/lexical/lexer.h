@@ -1,7 +1,11 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include "common/intern.h"
 #include "common/strslice.h"
+#include "frontend/error.h"
+
+#include <stdint.h>
 
 extern const char *token_type_strs[];
 typedef enum token_type {
@@ -16,23 +20,95 @@ typedef enum token_type {
 	TOK_KW_AND, TOK_KW_OR, TOK_KW_NOT, 
 	TOK_KW_TRUE, TOK_KW_FALSE, TOK_KW_NIL,
 	TOK_TYPE_NAT, TOK_TYPE_INT, TOK_TYPE_BOOL,
-	TOK_IDENT, TOK_LIT_NUM
+	TOK_IDENT, TOK_LIT_NUM,
+	TOK_TYPE_COUNT
 } token_type_t;
 
+/** A single token with its contents sliced out of the source. Tokens are not
+  * stored like this, it is only a convenient view of one of them.
+  */
 typedef struct token {
 	token_type_t type;
+	/// The position of the token in the token buffer.
+	uint32_t index;
+	/// The interned content of identifiers or `NO_SYMBOL` otherwise.
+	symbol_t symbol;
 	string_t content;
 } token_t;
 
-typedef struct token_list {
-	struct token_list *next;
-	token_t token;
-} token_list_t;
+/** All the tokens of a file laid out as a struct of arrays, indexed by the
+  * position of the token in the file. The last token is always `TOK_EOF`.
+  */
+typedef struct token_buffer {
+	/// The amount of tokens stored.
+	size_t count;
+	/// The amount of tokens the arrays have room for.
+	size_t capacity;
+	/// The `token_type_t` of each token.
+	uint8_t *types;
+	/// The offset of each token from the start of the file contents.
+	uint32_t *starts;
+	/// The length in bytes of each token.
+	uint32_t *lengths;
+	/// The interned content of each identifier or `NO_SYMBOL` otherwise.
+	symbol_t *symbols;
+} token_buffer_t;
+
+VECTOR_DEFINE(offset_list, uint32_t)
+
+/** The tokens of a single file along with a cursor over them. Lexers of
+  * different files are independent and can be used from different threads.
+  */
+typedef struct lexer {
+	string_file_t file;
+	token_buffer_t tokens;
+	intern_t symbols;
+	/// The index of the token that `lexer_next` will return next.
+	size_t next;
+	/// Where invalid characters are reported to.
+	error_sink_t *errors;
+	/// The offsets of the invalid characters in the file, in order. Each is
+	/// reported once the cursor gets to the first token after it, so that
+	/// the errors of the file are reported in order and the limit on them
+	/// keeps the first ones.
+	offset_list_t invalid;
+	/// How many of `invalid` have been reported.
+	size_t reported;
+	/// The index of the token whose turn reports the next of `invalid`, or
+	/// `SIZE_MAX` once all of them are.
+	size_t report_at;
+} lexer_t;
+
+/** Tokenizes the whole file up front into the token buffer and rewinds to
+  * its first token. The file must have been loaded with `str_file_load` and
+  * `scan_init` must have been called beforehand. Big files are cut into
+  * chunks that are lexed on threads of their own and stitched back together,
+  * the result is the same as lexing the file in one go.
+  * @param lexer The lexer to initialize, to be freed with `lexer_free`.
+  * @param file The file to tokenize.
+  * @param errors Where to report errors to.
+  * @param threads How many threads to lex the file with at most.
+  */
+void lexer_init(lexer_t *lexer, string_file_t file, error_sink_t *errors, size_t threads);
+void lexer_free(lexer_t *lexer);
+
+/// Returns the index of the token that `lexer_next` will return next.
+size_t lexer_tell(const lexer_t *lexer);
+/// Rewinds to a token index previously returned by `lexer_tell`.
+void lexer_backtrack(lexer_t *lexer, size_t index);
+/// Returns the next token and moves past it, unless it is `TOK_EOF`.
+token_t lexer_next(lexer_t *lexer);
+/// Reports the invalid characters that the cursor has not gotten to, for
+/// when the tokens are not going to be gone through to the end.
+void lexer_report_invalid(lexer_t *lexer);
+/// Returns the type of the token that `lexer_next` will return next.
+token_type_t lexer_peek(const lexer_t *lexer);
+/// Returns the token at the given index.
+token_t lexer_get(const lexer_t *lexer, size_t index);
 
-void lexer_init(string_file_t file);
-void lexer_backtrack(token_t *next_ptr);
-token_t *lexer_next(void);
-token_t *lexer_peek(void);
-string_t lexer_get_src(void);
+const token_buffer_t *lexer_get_tokens(const lexer_t *lexer);
+/// Returns the table the identifiers of the file were interned into.
+intern_t *lexer_get_symbols(lexer_t *lexer);
+string_t lexer_get_src(const lexer_t *lexer);
 
 #endif // LEXER_H
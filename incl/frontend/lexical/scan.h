@@ -0,0 +1,27 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+/** Scanning primitives used by the lexer to skip over runs of characters many
+  * bytes at a time. Every function expects a pointer into a null-terminated
+  * string that is followed by at least `STR_PADDING` readable bytes, such as
+  * the contents of a `string_file_t`, and never scans past the terminator.
+  * The widest implementation supported by the running CPU is picked once by
+  * `scan_init`, with a portable scalar fallback on every other platform.
+  */
+
+/// Selects the implementation of the scanning functions. Idempotent.
+void scan_init(void);
+
+/// Returns the first character that is not a space, tab or line break.
+const char *scan_space(const char *str);
+
+/// Returns the first character that can not be part of an identifier.
+const char *scan_ident(const char *str);
+
+/// Returns the first line break or the terminator, whichever comes first.
+const char *scan_line_end(const char *str);
+
+/// Returns the start of the first "*/" or the terminator, whichever comes first.
+const char *scan_comment_end(const char *str);
+
+#endif // SCAN_H
@@ -0,0 +1,23 @@
+#ifndef FOLD_H
+#define FOLD_H
+
+#include "common/strslice.h"
+#include "frontend/error.h"
+#include "frontend/syntactic/ast.h"
+
+/** Works out the value of every expression that can be known without
+  * running the program into the `folded` and `values` arrays of the tree.
+  * Those are the literals, the operators on known values, the variables that
+  * are given a known value and never assigned after, and the `if`s and
+  * blocks whose taken branch is known. Folded nodes have no effects so they
+  * can stand in for their value. Values wrap around in 64 bits like they do
+  * when the program runs, but arithmetic that overflows its type or divides
+  * by zero is reported and left unfolded, as is a known `nat` that is used
+  * as an `int` without fitting in one. Must run after `types_run`.
+  * @param file The file the tree was parsed from.
+  * @param ast The tree to fold.
+  * @param errors Where to report problems to.
+  */
+void fold_run(string_file_t file, ast_t *ast, error_sink_t *errors);
+
+#endif // FOLD_H
@@ -1,8 +1,19 @@
 #ifndef SCOPE_H
 #define SCOPE_H
 
+#include "common/strslice.h"
+#include "frontend/error.h"
 #include "frontend/syntactic/ast.h"
 
-void scope_run(ast_t *ast);
+/** Resolves every `AST_IDENT` of the tree to the `AST_VAR_SINGLE` that
+  * declares it, reporting undeclared, redeclared and shadowing variables.
+  * A variable is visible from after its declaration until the end of the
+  * `AST_BLOCK` it was declared in. Runs in time linear to the tree size.
+  * @param file The file the tree was parsed from.
+  * @param ast The tree to resolve the identifiers of.
+  * @param symbol_count How many symbols were interned for the file.
+  * @param errors Where to report problems to.
+  */
+void scope_run(string_file_t file, ast_t *ast, size_t symbol_count, error_sink_t *errors);
 
 #endif // SCOPE_H
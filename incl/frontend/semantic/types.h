@@ -0,0 +1,47 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include "common/strslice.h"
+#include "frontend/error.h"
+#include "frontend/syntactic/ast.h"
+
+#include <stdint.h>
+
+/** The builtin types. `UNKNOWN` is given to whatever could not be typed,
+  * like erroneous expressions and calls to functions that are not declared
+  * anywhere, and fits wherever any other type would so that a single error
+  * is never reported over and over. `NEVER` is the type of `return`, which
+  * never produces a value and so fits wherever any other type would too.
+  */
+#define FOREACH_TYPE(FN) \
+	FN(UNKNOWN, "unknown") FN(NAT, "nat") FN(INT, "int") \
+	FN(BOOL, "bool") FN(NIL, "nil") FN(NEVER, "never")
+
+#define GENERATE_TYPE_ENUM(ID, NAME) TYPE_##ID,
+#define GENERATE_TYPE_STRS(ID, NAME) NAME,
+
+/** Every distinct type is interned as a single small integer, so types are
+  * compared as integers. Only the builtin types exist so far, which are
+  * interned up front in the order of `FOREACH_TYPE`.
+  */
+typedef uint8_t type_id_t;
+
+enum type_ids {
+	FOREACH_TYPE(GENERATE_TYPE_ENUM)
+	TYPE_COUNT
+};
+
+extern const char *type_names[];
+
+/** Gives every node of the tree a type in the `types` array of the tree and
+  * reports the nodes whose types do not fit together. Declarations without
+  * an annotation take the type of their value, an `if` used as a value has
+  * the type its branches agree on and `nat` fits where `int` is expected.
+  * Must run after `scope_run`, in a single pass over the tree.
+  * @param file The file the tree was parsed from.
+  * @param ast The tree to type.
+  * @param errors Where to report problems to.
+  */
+void types_run(string_file_t file, ast_t *ast, error_sink_t *errors);
+
+#endif // TYPES_H
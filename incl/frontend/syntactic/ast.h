@@ -4,48 +4,125 @@
 #include "nodes.h"
 
 #include "common/arena.h"
+#include "common/intern.h"
 #include "common/strslice.h"
+#include "common/vector.h"
+#include "frontend/lexical/lexer.h"
+
+#include <stdbool.h>
+#include <stdint.h>
 
 #define AST_FIRST_LIST_NODE AST_INTERNAL
 
 extern const char *node_type_strs[];
 typedef enum ast_node_type {
 	FOREACH_NODE(GENERATE_AST_ENUM)
+	AST_NODE_COUNT
 } ast_node_type_t;
 
-#pragma GCC diagnostic push 
-#pragma GCC diagnostic ignored "-Wpedantic"
+/// The index of a node in the node array of its tree.
+typedef uint32_t ast_ref_t;
+/// The reference to no node, the slot it points to is a placeholder.
+#define AST_NONE ((ast_ref_t) 0)
+/// The token index of nodes that do not stand for any token.
+#define AST_NO_TOKEN UINT32_MAX
+
+/** A node of the tree. Nodes refer to their children and tokens by index so
+  * they are small and stored back to back in a single array.
+  */
 typedef struct ast_node {
 	ast_node_type_t type;
-	string_t content;
+	/// The index of the token the node was made from or `AST_NO_TOKEN`.
+	uint32_t token;
 	union {
 		struct {
-			struct ast_node *left;
-			struct ast_node *right;
+			ast_ref_t left;
+			ast_ref_t right;
 		} pair;
+		/// A range of the `lists` array of the tree.
 		struct {
-			size_t count;
-			size_t capacity;
-			struct ast_node *list[];
+			uint32_t first;
+			uint32_t count;
 		} list;
 	} children;
 } ast_node_t;
-#pragma GCC diagnostic pop
+
+VECTOR_DEFINE(ast_node_list, ast_node_t)
+VECTOR_DEFINE(ast_ref_list, ast_ref_t)
 
 typedef struct ast {
+	/// The tokens the nodes refer to and the source they were read from.
+	const token_buffer_t *tokens;
+	string_t src;
+	/// Every node of the tree, the first one being the `AST_NONE` placeholder.
+	ast_node_list_t nodes;
+	/// The children of all list nodes, each list is a contiguous range.
+	ast_ref_list_t lists;
+	ast_ref_t root;
+	/// The `AST_VAR_SINGLE` each `AST_IDENT` resolves to, set by `scope_run`.
+	ast_ref_t *decls;
+	/// The `type_id_t` of every node, set by `types_run`.
+	uint8_t *types;
+	/// Whether the value of each node is known without running it and the
+	/// value if so, set by `fold_run`.
+	bool *folded;
+	uint64_t *values;
+	/// Holds the side arrays that annotate the nodes.
 	arena_t arena;
-	ast_node_t *root;
 } ast_t;
 
-ast_node_t *ast_pnode_new(ast_t *tree, ast_node_type_t type,string_t content);
-#define ast_pnode_left(parent,child) (parent->children.pair.left = child)
-#define ast_pnode_right(parent,child) (parent->children.pair.right = child)
+/// Returns the node a reference points to. Invalidated by adding nodes.
+static inline ast_node_t *ast_get(const ast_t *tree, ast_ref_t ref) {
+	return &tree->nodes.data[ref];
+}
+
+/// Returns the children of a list node. Invalidated by adding lists.
+static inline const ast_ref_t *ast_lnode_children(const ast_t *tree, ast_ref_t ref) {
+	return &tree->lists.data[tree->nodes.data[ref].children.list.first];
+}
+
+/// Returns how many child slots a node has, some of which may be `AST_NONE`.
+static inline size_t ast_child_count(const ast_t *tree, ast_ref_t ref) {
+	const ast_node_t *node = &tree->nodes.data[ref];
+	if(node->type < AST_FIRST_LIST_NODE) return 2;
+	return node->children.list.count;
+}
+
+/// Returns the child in the given slot of a node, pairs have left then right.
+static inline ast_ref_t ast_child(const ast_t *tree, ast_ref_t ref, size_t index) {
+	const ast_node_t *node = &tree->nodes.data[ref];
+	if(node->type >= AST_FIRST_LIST_NODE)
+		return tree->lists.data[node->children.list.first + index];
+	return index == 0 ? node->children.pair.left : node->children.pair.right;
+}
+
+ast_ref_t ast_pnode_new(ast_t *tree, ast_node_type_t type, uint32_t token);
+
+static inline void ast_pnode_left(ast_t *tree, ast_ref_t parent, ast_ref_t child) {
+	tree->nodes.data[parent].children.pair.left = child;
+}
+
+static inline void ast_pnode_right(ast_t *tree, ast_ref_t parent, ast_ref_t child) {
+	tree->nodes.data[parent].children.pair.right = child;
+}
+
+/** Creates a list node without children. Lists are built elsewhere and only
+  * stored with `ast_lnode_set` once complete, which keeps them contiguous.
+  */
+ast_ref_t ast_lnode_new(ast_t *tree, ast_node_type_t type, uint32_t token);
+void ast_lnode_set(ast_t *tree, ast_ref_t parent, const ast_ref_t *children, size_t count);
+
+/// Returns the source text of the token of a node or an empty string.
+string_t ast_node_content(const ast_t *tree, ast_ref_t ref);
+/// Returns the interned name of the token of a node or `NO_SYMBOL`.
+symbol_t ast_node_symbol(const ast_t *tree, ast_ref_t ref);
 
-ast_node_t *ast_lnode_new(ast_t *tree, size_t capacity, ast_node_type_t type, string_t content);
-ast_node_t *ast_lnode_add(ast_t *tree, ast_node_t *parent, ast_node_t *child);
+/** Allocates an array with a zeroed element for every node of the tree,
+  * meant for passes to annotate the nodes with. Freed along with the tree.
+  */
+void *ast_side_array(ast_t *tree, size_t unit_size);
 
-ast_t ast_tree_new(void);
+ast_t ast_tree_new(const token_buffer_t *tokens, string_t src);
 void ast_tree_free(ast_t *tree);
-void ast_tree_visualize(ast_t *tree);
 
 #endif // AST_H
@@ -0,0 +1,36 @@
+#ifndef DUMP_H
+#define DUMP_H
+
+#include "ast.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef enum ast_dump_format {
+	/// An indented tree for people to read, colored on terminals.
+	AST_DUMP_TREE,
+	/// A single line of nested `(TYPE "text" children...)` lists.
+	AST_DUMP_SEXPR,
+	/// A single line of nested `{"type", "text", "children"}` objects.
+	AST_DUMP_JSON
+} ast_dump_format_t;
+
+/** Parses the name of a dump format as given on the command line.
+  * @param name One of "tree", "sexpr" or "json".
+  * @param format Where to store the format that was named.
+  * @return Whether the name is that of a format.
+  */
+bool ast_dump_parse_format(const char *name, ast_dump_format_t *format);
+
+/** Writes out the whole tree in the given format. Output goes through a
+  * single large buffer so the stream is written in few big chunks. Colors
+  * are only used by the tree format and only if the stream is a terminal.
+  * In the compact formats an empty child slot is written as `()` or `null`
+  * when a later slot is not empty, so that children keep their positions.
+  * @param tree The tree to write out.
+  * @param out The stream to write to.
+  * @param format The format to write the tree in.
+  */
+void ast_dump(ast_t *tree, FILE *out, ast_dump_format_t format);
+
+#endif // DUMP_H
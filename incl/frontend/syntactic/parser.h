@@ -1,8 +1,15 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include "ast.h"
+#include "frontend/error.h"
+#include "frontend/lexical/lexer.h"
+
 #include <stdbool.h>
 
-void parser_run(string_file_t file, ast_t *empty);
+/** Builds the tree of the tokens of a lexer, reporting problems to a sink.
+  * @return Whether the tree is complete, a fatal error leaves it without a root.
+  */
+bool parser_run(lexer_t *lexer, error_sink_t *errors, ast_t *empty);
 
 #endif // PARSER_H
@@ -0,0 +1,48 @@
+#ifndef VISITOR_H
+#define VISITOR_H
+
+#include "ast.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Where the walk currently is, handed to every callback of a visitor.
+  */
+typedef struct ast_visit {
+	ast_t *tree;
+	/// The node being visited.
+	ast_ref_t node;
+	/// The parent of the node or `AST_NONE` for the node the walk started at.
+	ast_ref_t parent;
+	/// How many ancestors of the node the walk has gone through.
+	uint32_t depth;
+	/// Whether no sibling of the node is left to visit after it.
+	bool last;
+	/// The context pointer of the visitor.
+	void *context;
+} ast_visit_t;
+
+/// Called before the children of a node, returns whether to visit them.
+typedef bool (*ast_pre_fn)(const ast_visit_t *visit);
+/// Called after the children of a node, even if they were skipped.
+typedef void (*ast_post_fn)(const ast_visit_t *visit);
+
+/** A set of callbacks for each node type, either of which may be `NULL`. The
+  * children of a node without a `pre` callback are always visited.
+  */
+typedef struct ast_visitor {
+	ast_pre_fn pre[AST_NODE_COUNT];
+	ast_post_fn post[AST_NODE_COUNT];
+	void *context;
+} ast_visitor_t;
+
+/** Walks the subtree of a node depth first and left to right, skipping empty
+  * child slots. The walk keeps its own stack on the heap rather than using
+  * recursion so it handles any depth of nesting.
+  * @param tree The tree the node belongs to.
+  * @param root The node to start from.
+  * @param visitor The callbacks to call for each node.
+  */
+void ast_walk(ast_t *tree, ast_ref_t root, const ast_visitor_t *visitor);
+
+#endif // VISITOR_H
@@ -0,0 +1,133 @@
+#ifndef IR_H
+#define IR_H
+
+#include "common/arena.h"
+#include "common/vector.h"
+#include "frontend/syntactic/ast.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/** The operations of the IR. Every instruction produces at most one value
+  * and the last instruction of every block is one of the terminators, `JUMP`,
+  * `BRANCH` or `RETURN`. Division, remainder and ordering come in a signed
+  * and an unsigned (`U`) flavor, picked by whether the operands are `nat`.
+  */
+#define FOREACH_IR_OP(FN) \
+	FN(CONST, "const") FN(PHI, "phi") FN(CALL, "call") \
+	FN(NEG, "neg") FN(NOT, "not") \
+	FN(ADD, "add") FN(SUB, "sub") FN(MUL, "mul") \
+	FN(DIV, "div") FN(UDIV, "udiv") FN(MOD, "mod") FN(UMOD, "umod") \
+	FN(EQ, "eq") FN(NE, "ne") FN(LT, "lt") FN(ULT, "ult") FN(LE, "le") FN(ULE, "ule") \
+	FN(JUMP, "jump") FN(BRANCH, "branch") FN(RETURN, "return")
+
+#define GENERATE_IR_ENUM(ID, NAME) IR_##ID,
+#define GENERATE_IR_STRS(ID, NAME) NAME,
+
+extern const char *ir_op_names[];
+typedef enum ir_op {
+	FOREACH_IR_OP(GENERATE_IR_ENUM)
+	IR_OP_COUNT
+} ir_op_t;
+
+/// The index of an instruction, which doubles as the value it produces.
+typedef uint32_t ir_ref_t;
+/// The reference to no instruction, the slot it points to is a placeholder.
+#define IR_NONE ((ir_ref_t) 0)
+
+/// The index of a basic block.
+typedef uint32_t ir_label_t;
+#define IR_NO_BLOCK UINT32_MAX
+
+/** An instruction. Operands refer to other instructions by index so that
+  * instructions are small and stored back to back in a single array.
+  */
+typedef struct ir_inst {
+	/// The `ir_op_t` of the instruction.
+	uint8_t op;
+	/// The `type_id_t` of the value it produces.
+	uint8_t type;
+	/// The node it was lowered from, for later passes to report problems at.
+	ast_ref_t node;
+	union {
+		/// The value of `IR_CONST`, `nat` and `int` use all 64 bits.
+		uint64_t constant;
+		/// The operands of everything else, the condition of `IR_BRANCH`
+		/// and the incoming values of `IR_PHI` in order of predecessors.
+		ir_ref_t args[2];
+		/// The arguments of `IR_CALL`, a range of the `operands` array.
+		struct {
+			uint32_t first;
+			uint32_t count;
+		} list;
+	} data;
+} ir_inst_t;
+
+/** A basic block. Every merge in the language joins two paths, so a block
+  * has at most two predecessors as well as at most two successors.
+  */
+typedef struct ir_block {
+	/// The range of the `insts` array the block is made of. Phis come first
+	/// and the terminator last.
+	uint32_t first;
+	uint32_t count;
+	ir_label_t preds[2];
+	uint32_t pred_count;
+	/// The target of `IR_JUMP`, or the targets of `IR_BRANCH` for when the
+	/// condition holds and when it does not.
+	ir_label_t succs[2];
+} ir_block_t;
+
+VECTOR_DEFINE(ir_inst_list, ir_inst_t)
+VECTOR_DEFINE(ir_block_list, ir_block_t)
+VECTOR_DEFINE(ir_ref_list, ir_ref_t)
+
+/** A program in SSA form. Blocks are numbered in the order they are laid
+  * out and their instructions follow each other in the `insts` array, so
+  * walking the array walks the whole program. Everything lives in the arena
+  * of the IR and is freed with it.
+  */
+typedef struct ir {
+	/// The tree it was lowered from, which the instructions point into.
+	const ast_t *ast;
+	/// Every instruction, the first one being the `IR_NONE` placeholder.
+	ir_inst_list_t insts;
+	/// Every block, the first one being where the program starts.
+	ir_block_list_t blocks;
+	/// The arguments of all calls, each list is a contiguous range.
+	ir_ref_list_t operands;
+	arena_t arena;
+} ir_t;
+
+/// Returns the instruction a reference points to. Invalidated by adding.
+static inline ir_inst_t *ir_get(const ir_t *ir, ir_ref_t ref) {
+	return &ir->insts.data[ref];
+}
+
+/// Returns a block. Invalidated by adding blocks.
+static inline ir_block_t *ir_block(const ir_t *ir, ir_label_t label) {
+	return &ir->blocks.data[label];
+}
+
+/** Makes an empty program with only the `IR_NONE` placeholder in it. The
+  * containers refer to the arena inside the struct so it must not be moved.
+  * @param ir The program to initialize, to be freed with `ir_free`.
+  * @param ast The tree the program is going to be lowered from.
+  */
+void ir_init(ir_t *ir, const ast_t *ast);
+void ir_free(ir_t *ir);
+
+/// Appends an instruction to the `insts` array and returns its index.
+ir_ref_t ir_add(ir_t *ir, ir_inst_t inst);
+/// Appends an empty block without predecessors and returns its label.
+ir_label_t ir_add_block(ir_t *ir);
+
+/** Writes out the program one instruction per line, as in
+  * `%3 = add nat %1, %2`, with every block headed by its label and its
+  * predecessors.
+  * @param ir The program to write out.
+  * @param out The stream to write to.
+  */
+void ir_dump(const ir_t *ir, FILE *out);
+
+#endif // IR_H
@@ -0,0 +1,24 @@
+#ifndef LOWER_H
+#define LOWER_H
+
+#include "ir.h"
+
+#include "frontend/syntactic/ast.h"
+
+/** Lowers a tree that passed the semantic checks into SSA form. Control flow
+  * is structured, so the SSA form is built in a single pass over the tree:
+  * the current value of every variable is tracked along the way, the values
+  * two paths leave a variable with are joined by a phi where the paths meet
+  * and loops get a phi in their header for every variable assigned in them.
+  * Phis that turn out to select a single value are removed afterwards and
+  * the blocks are numbered in the order they are laid out. `and` and `or`
+  * only evaluate their right side when it decides the result and `return`
+  * leaves the program, the file being the only routine there is so far.
+  * Folded nodes become constants and the branches and loops that are known
+  * not to run are left out.
+  * @param ast The tree to lower, after `scope_run`, `types_run` and `fold_run`.
+  * @param ir The empty program to lower into, made with `ir_init`.
+  */
+void lower_run(ast_t *ast, ir_t *ir);
+
+#endif // LOWER_H
@@ -1,85 +1,126 @@
 #include "arena.h"
 
+#include "common/stats.h"
 #include "frontend/error.h"
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 // Internal Functions //
 
-static region_t *_create_region(size_t block_size) {
-	// round up to the next highest mutliple of uintptr_t
-	size_t header = (sizeof(region_t) - 1) / sizeof(uintptr_t) + 1;
-	// ask libc for a new zeroed region and initialise it
-	region_t *region = (region_t *) calloc(header + block_size, sizeof(uintptr_t));
+static region_t *_create_region(arena_t *arena, size_t size_bytes) {
+	// ask libc for a new region, zeroed if the arena promises so
+	size_t total_bytes = sizeof(region_t) + size_bytes;
+	region_t *region = (region_t *) (arena->zeroed ?
+		calloc(1, total_bytes) : malloc(total_bytes));
 	error_if(region == NULL);
-	region->next = NULL, region->used = 0; // redundant
-	region->size = block_size;
+	region->next = NULL, region->used = 0;
+	region->size = size_bytes;
+	memory_stats_local()->arena_reserved += size_bytes;
+	memory_stats_local()->arena_regions++;
 	return region;
 }
 
-static void *_alloc_first(arena_t *arena, size_t block_size_bytes) {
-	// this function should only have been called on empty arenas
-	assert(arena->first == NULL && arena->last == NULL);
-	
-	// calculate the rounded up size of the block and use that for
-	// the size of the new region if it's bigger than the minimum
-	size_t block_size = (block_size_bytes - 1) / sizeof(uintptr_t) + 1;
-	size_t new_region_size = arena->min_region_size;
-	if(new_region_size < block_size) new_region_size = block_size;
-
-	// create the region and link it to the arena
-	region_t *new_region = _create_region(new_region_size);
-	if(new_region == NULL) return NULL;
-	arena->first = arena->last = new_region;
-
-	// no need index into data, it's guaranteed to be empty
-	void *block = (void *) &arena->last->data;
-	arena->last->used += block_size;
-	return block;
+static arena_t _new_arena(size_t min_region_size_bytes, bool zeroed) {
+	// round up to the next highest mutliple of uintptr_t
+	size_t min_region_size = (min_region_size_bytes - 1) / sizeof(uintptr_t) + 1;
+	return (arena_t) {
+		.min_region_size = min_region_size * sizeof(uintptr_t),
+		.zeroed = zeroed,
+		.first = NULL, .last = NULL,
+		.requested = 0, .wasted = 0
+	};
 }
 
 // External Functions //
 
 arena_t arena_new(size_t min_region_size_bytes) {
-	// round up to the next highest mutliple of uintptr_t
-	size_t min_region_size = (min_region_size_bytes - 1) / sizeof(uintptr_t) + 1;
-	return (arena_t) {
-		.min_region_size = min_region_size,
-		.first = NULL, .last = NULL
-	};
+	return _new_arena(min_region_size_bytes, true);
 }
 
-void *arena_alloc(arena_t *arena, size_t block_size_bytes) {
-	// call the first allocation function instead if the arena is empty
-	if(arena->first == NULL) {
-		assert(arena->last == NULL);
-		return _alloc_first(arena, block_size_bytes);
-	}
+arena_t arena_new_raw(size_t min_region_size_bytes) {
+	return _new_arena(min_region_size_bytes, false);
+}
+
+void *arena_alloc_slow(arena_t *arena, size_t block_size_bytes, size_t alignment) {
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	assert((arena->first == NULL) == (arena->last == NULL));
+
+	// the regions past the last one are empty leftovers of `arena_reset_to`
+	// so only the one right after it needs to be checked for space
+	size_t needed = block_size_bytes + alignment - 1;
+	region_t *next = arena->last == NULL ? NULL : arena->last->next;
+	if(next == NULL || next->size < needed) {
+		// grow geometrically so that the amount of regions stays logarithmic
+		size_t new_region_size = arena->min_region_size;
+		if(arena->last != NULL) {
+			size_t grown = arena->last->size * 2;
+			if(grown > ARENA_MAX_GROWTH) grown = ARENA_MAX_GROWTH;
+			if(new_region_size < grown) new_region_size = grown;
+		}
+		if(new_region_size < needed) new_region_size = needed;
 
-	// * the block size calculation can be pulled out the loop
-	size_t block_size = (block_size_bytes - 1) / sizeof(uintptr_t) + 1;
-	for(region_t *curr = arena->last; curr != NULL; curr = curr->next) {
-		// if it fits into the current region then we are done
-		if(block_size + curr->used <= curr->size) break;
-		// if instead we reached the last region and it still doesn't fit
-		if(curr->next == NULL) {
-			// calculate the rounded up size of the block and use that for
-			// the size of the new region if it's bigger than the minimum *
-			size_t new_region_size = arena->min_region_size;
-			if(new_region_size < block_size) new_region_size = block_size;
-
-			// create the region and link it to the previously last one
-			region_t *new_region = _create_region(new_region_size);
-			if(new_region == NULL) return NULL;
-			curr->next = new_region;
+		// create the region and link it right after the last one
+		region_t *new_region = _create_region(arena, new_region_size);
+		if(arena->last == NULL) arena->first = new_region;
+		else {
+			new_region->next = arena->last->next;
+			arena->last->next = new_region;
 		}
-		arena->last = curr->next;
+		next = new_region;
 	}
 
-	void *block = (void *) &arena->last->data[arena->last->used];
-	arena->last->used += block_size;
-	return block;
+	// the rest of the last region stays unused until a reset
+	if(arena->last != NULL) arena->wasted += arena->last->size - arena->last->used;
+
+	// now guaranteed to take the fast path
+	arena->last = next;
+	return arena_alloc_aligned(arena, block_size_bytes, alignment);
+}
+
+bool arena_extend(arena_t *arena, void *block, size_t old_size_bytes, size_t new_size_bytes) {
+	assert(new_size_bytes >= old_size_bytes);
+	region_t *region = arena->last;
+	if(region == NULL) return false;
+	// only the block that ends where the free space starts can grow
+	if((uint8_t *) block + old_size_bytes != &region->data[region->used]) return false;
+	size_t extra_bytes = new_size_bytes - old_size_bytes;
+	if(extra_bytes > region->size - region->used) return false;
+	region->used += extra_bytes;
+	arena->requested += extra_bytes;
+	return true;
+}
+
+bool arena_owns(const arena_t *arena, const void *pointer) {
+	for(region_t *curr = arena->first; curr != NULL; curr = curr->next) {
+		// compared as integers since the pointer may be from another object
+		uintptr_t begin = (uintptr_t) curr->data, end = begin + curr->size;
+		if((uintptr_t) pointer >= begin && (uintptr_t) pointer < end) return true;
+	}
+	return false;
+}
+
+arena_mark_t arena_mark(arena_t *arena) {
+	return (arena_mark_t) {
+		.region = arena->last,
+		.used = arena->last == NULL ? 0 : arena->last->used
+	};
+}
+
+void arena_reset_to(arena_t *arena, arena_mark_t mark) {
+	if(arena->last == NULL) return;
+	region_t *stop = arena->last->next;
+	region_t *curr = mark.region == NULL ? arena->first : mark.region;
+	size_t keep = mark.region == NULL ? 0 : mark.used;
+
+	for(; curr != stop; curr = curr->next, keep = 0) {
+		assert(keep <= curr->used);
+		// keep the promise that blocks come zeroed
+		if(arena->zeroed) memset(&curr->data[keep], 0, curr->used - keep);
+		curr->used = keep;
+	}
+	arena->last = mark.region == NULL ? arena->first : mark.region;
 }
 
 void arena_free(arena_t *arena) {
@@ -95,4 +136,9 @@ void arena_free(arena_t *arena) {
 	}
 	arena->first = NULL;
 	arena->last = NULL;
+
+	memory_stats_t *stats = memory_stats_local();
+	stats->arena_requested += arena->requested;
+	stats->arena_wasted += arena->wasted;
+	arena->requested = arena->wasted = 0;
 }
@@ -0,0 +1,93 @@
+#include "intern.h"
+
+#include "common/stats.h"
+#include "frontend/error.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 256
+
+// Internal Functions //
+
+// 32-bit FNV-1a, identifiers are short so anything fancier does not pay off
+static uint32_t hash_string(string_t string) {
+	uint32_t hash = 2166136261u;
+	for(size_t i=0; i<string.size; i++) {
+		hash ^= (uint8_t) string.string[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void allocate_slots(intern_t *table, size_t capacity) {
+	table->capacity = capacity;
+	table->slots = (uint32_t *) arena_alloc(&table->arena, capacity * sizeof(uint32_t));
+	table->hashes = (uint32_t *) arena_alloc(&table->arena, capacity * sizeof(uint32_t));
+	error_if(table->slots == NULL || table->hashes == NULL);
+}
+
+static void grow(intern_t *table) {
+	uint32_t *old_slots = table->slots, *old_hashes = table->hashes;
+	size_t old_capacity = table->capacity;
+	// the old arrays are abandoned in the arena, at most as big as the new ones
+	allocate_slots(table, old_capacity * 2);
+	memory_stats_local()->arena_wasted += old_capacity * 2 * sizeof(uint32_t);
+
+	size_t mask = table->capacity - 1;
+	for(size_t i=0; i<old_capacity; i++) {
+		if(old_slots[i] == 0) continue;
+		size_t slot = old_hashes[i] & mask;
+		while(table->slots[slot] != 0) slot = (slot + 1) & mask;
+		table->slots[slot] = old_slots[i];
+		table->hashes[slot] = old_hashes[i];
+	}
+}
+
+// External Functions //
+
+intern_t intern_new(void) {
+	intern_t table = {.arena = arena_new(4096)};
+	allocate_slots(&table, INITIAL_CAPACITY);
+	table.strings = string_list_new(NULL, INITIAL_CAPACITY / 2);
+	return table;
+}
+
+symbol_t intern_get(intern_t *table, string_t string) {
+	uint32_t hash = hash_string(string);
+	size_t mask = table->capacity - 1;
+	size_t slot = hash & mask;
+
+	// linear probing, the load factor is kept at or below one half
+	for(; table->slots[slot] != 0; slot = (slot + 1) & mask) {
+		if(table->hashes[slot] != hash) continue;
+		symbol_t symbol = table->slots[slot] - 1;
+		string_t *other = &table->strings.data[symbol];
+		if(other->size == string.size && !memcmp(other->string, string.string, string.size))
+			return symbol;
+	}
+
+	symbol_t symbol = (symbol_t) table->strings.count;
+	assert(symbol < NO_SYMBOL - 1);
+	string_list_push(&table->strings, string);
+	table->slots[slot] = symbol + 1;
+	table->hashes[slot] = hash;
+	if(table->strings.count * 2 > table->capacity) grow(table);
+	return symbol;
+}
+
+string_t intern_string(const intern_t *table, symbol_t symbol) {
+	if(symbol >= table->strings.count) return EMPTY_STRING;
+	return table->strings.data[symbol];
+}
+
+size_t intern_count(const intern_t *table) {
+	return table->strings.count;
+}
+
+void intern_free(intern_t *table) {
+	arena_free(&table->arena);
+	table->slots = table->hashes = NULL;
+	string_list_free(&table->strings);
+	table->capacity = 0;
+}
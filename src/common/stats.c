@@ -0,0 +1,38 @@
+#include "stats.h"
+
+#include "frontend/error.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+static pthread_once_t local_once = PTHREAD_ONCE_INIT;
+static pthread_key_t local_key;
+
+// Internal Functions //
+
+static void local_key_create(void) {
+	error_if(pthread_key_create(&local_key, free) != 0);
+}
+
+// External Functions //
+
+memory_stats_t *memory_stats_local(void) {
+	error_if(pthread_once(&local_once, local_key_create) != 0);
+	memory_stats_t *stats = (memory_stats_t *) pthread_getspecific(local_key);
+	if(stats != NULL) return stats;
+	// Only the first call of each thread gets here
+	stats = (memory_stats_t *) calloc(1, sizeof(memory_stats_t));
+	error_if(stats == NULL || pthread_setspecific(local_key, stats) != 0);
+	return stats;
+}
+
+void memory_stats_accumulate(memory_stats_t *total, const memory_stats_t *before, const memory_stats_t *after) {
+	#define ADD(m_field) total->m_field += after->m_field - before->m_field
+	ADD(arena_requested);
+	ADD(arena_reserved);
+	ADD(arena_regions);
+	ADD(arena_wasted);
+	ADD(vector_regrowths);
+	ADD(vector_regrowths_in_place);
+	#undef ADD
+}
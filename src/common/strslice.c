@@ -1,38 +1,186 @@
+// Needed for mmap's MAP_ANONYMOUS and madvise under strict C99
+#define _DEFAULT_SOURCE
+
 #include "strslice.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Internal Functions //
+
+static string_file_t map_file(int fd, size_t size) {
+	string_file_t file = {.content = EMPTY_STRING, .mapped = true};
+
+	// Reserve room for the file plus the terminator and the padding as a
+	// zeroed anonymous mapping, then map the file itself on top of it. The
+	// part of the last page of the file past its end is zeroed by the kernel.
+	size_t page = (size_t) sysconf(_SC_PAGESIZE);
+	size_t reserved = ((size + 1 + STR_PADDING) + page - 1) / page * page;
+	void *base = mmap(NULL, reserved, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(base == MAP_FAILED) return file;
+	void *view = mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+	if(view == MAP_FAILED) {
+		int saved_errno = errno;
+		munmap(base, reserved);
+		errno = saved_errno;
+		return file;
+	}
+
+	// The contents are only ever walked from front to back
+	madvise(base, size, MADV_SEQUENTIAL);
+	file.content = CONSTRUCT_STR(size + 1, (char *) base);
+	file.reserved = reserved;
+	return file;
+}
+
+static bool index_lines(string_file_t *file) {
+	size_t capacity = 1024, count = 1;
+	size_t *starts = (size_t *) malloc(capacity * sizeof(size_t));
+	if(starts == NULL) return false;
+	starts[0] = 0;
+
+	// memchr is vectorized by libc, the newlines are sparse enough for it to
+	// skip over most of the contents many bytes at a time
+	const char *begin = file->content.string;
+	const char *end = begin + file->content.size;
+	for(const char *c = begin; (c = memchr(c, '\n', end - c)) != NULL; ) {
+		if(count == capacity) {
+			capacity *= 2;
+			size_t *new_starts = (size_t *) realloc(starts, capacity * sizeof(size_t));
+			if(new_starts == NULL) {
+				free(starts);
+				return false;
+			}
+			starts = new_starts;
+		}
+		starts[count++] = (size_t) (++c - begin);
+	}
+
+	file->line_starts = starts;
+	file->lines = (unsigned) count;
+	return true;
+}
+
+// External Functions //
 
 string_t str_read(FILE *fdesc) {
-	const size_t buffer_size =  4096;
-	char read_buffer[buffer_size];
-	string_t result = { .size = 0, .string = NULL };
-
-	for(bool finished = false; !finished; ) {
-		size_t read_amount = fread(read_buffer, 1, buffer_size, fdesc);
-		if(read_amount < buffer_size) finished = true, read_amount++;
-
-		size_t new_size = result.size + read_amount;
-		char *new_string = (char *) realloc(result.string, new_size);
-		if(!new_string) {
-			if(result.string) free(result.string);
-			result.string = NULL;
-			return result;
+	size_t capacity = 4096, size = 0;
+	char *buffer = (char *) malloc(capacity);
+	if(!buffer) return EMPTY_STRING;
+
+	while(true) {
+		// always keep room for the terminator and the padding
+		size_t wanted = capacity - size - STR_PADDING - 1;
+		size_t read_amount = fread(&buffer[size], 1, wanted, fdesc);
+		size += read_amount;
+		if(read_amount < wanted) break;
+
+		capacity *= 2;
+		char *new_buffer = (char *) realloc(buffer, capacity);
+		if(!new_buffer) {
+			free(buffer);
+			return EMPTY_STRING;
 		}
+		buffer = new_buffer;
+	}
 
-		memcpy(&new_string[result.size], read_buffer, read_amount);
-		result.size += read_amount, result.string = new_string;
-		if(finished) result.string[result.size - 1] = '\0';
+	if(ferror(fdesc)) {
+		free(buffer);
+		return EMPTY_STRING;
 	}
-	
-	return result;
+
+	memset(&buffer[size], 0, STR_PADDING + 1);
+	return CONSTRUCT_STR(size + 1, buffer);
+}
+
+string_file_t str_file_load(const char *path) {
+	string_t name = CONSTRUCT_STR(strlen(path), (char *) path);
+	string_file_t file = {.name = name, .content = EMPTY_STRING};
+
+	FILE *fdesc = NULL;
+	if(strcmp(path, "-") == 0) fdesc = stdin;
+	else {
+		int fd = open(path, O_RDONLY);
+		if(fd < 0) return file;
+
+		struct stat info;
+		if(fstat(fd, &info) < 0) {
+			int saved_errno = errno;
+			close(fd);
+			errno = saved_errno;
+			return file;
+		}
+
+		// Only non-empty regular files can be mapped
+		if(S_ISREG(info.st_mode) && info.st_size > 0) {
+			string_file_t mapped = map_file(fd, (size_t) info.st_size);
+			int saved_errno = errno;
+			close(fd);
+			errno = saved_errno;
+			if(mapped.content.string == NULL) return file;
+			mapped.name = name;
+			if(!index_lines(&mapped)) str_file_free(&mapped);
+			return mapped;
+		}
+
+		fdesc = fdopen(fd, "r");
+		if(fdesc == NULL) {
+			int saved_errno = errno;
+			close(fd);
+			errno = saved_errno;
+			return file;
+		}
+	}
+
+	file.content = str_read(fdesc);
+	file.reserved = file.content.size + STR_PADDING;
+	file.mapped = false;
+	if(fdesc != stdin) {
+		int saved_errno = errno;
+		fclose(fdesc);
+		errno = saved_errno;
+	}
+	if(file.content.string != NULL && !index_lines(&file)) str_file_free(&file);
+	return file;
+}
+
+void str_file_free(string_file_t *file) {
+	if(file->content.string == NULL) return;
+	if(file->mapped) munmap(file->content.string, file->reserved);
+	else free(file->content.string);
+	free(file->line_starts);
+	file->content = EMPTY_STRING;
+	file->line_starts = NULL;
+	file->reserved = 0;
+	file->lines = 0;
+}
+
+void str_file_locate(const string_file_t *file, const char *spot, unsigned *row, unsigned *column) {
+	size_t offset = (size_t) (spot - file->content.string);
+
+	// find the last line that starts at or before the offset
+	unsigned low = 0, high = file->lines;
+	while(high - low > 1) {
+		unsigned middle = low + (high - low) / 2;
+		if(file->line_starts[middle] <= offset) low = middle;
+		else high = middle;
+	}
+
+	*row = low;
+	*column = (unsigned) (offset - file->line_starts[low]);
 }
 
-unsigned str_count_lines(string_t string) {
-	if(string.size == 0 || string.string == NULL) return 0;
-	unsigned count = 1;
-	for(size_t i=0; i<string.size; i++)
-		if(string.string[i] == '\n') count++;
-	return count;
+string_t str_file_get_line(const string_file_t *file, unsigned row) {
+	if(row >= file->lines) return EMPTY_STRING;
+	size_t start = file->line_starts[row];
+	// the last line ends at the terminator rather than a line break
+	size_t end = file->content.size - 1;
+	if(row + 1 < file->lines) end = file->line_starts[row + 1] - 1;
+	return CONSTRUCT_STR(end - start, &file->content.string[start]);
 }
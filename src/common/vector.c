@@ -1,7 +1,35 @@
 #include "vector.h"
 
+#include "common/stats.h"
+#include "frontend/error.h"
+
 #include <string.h>
 
+// Internal Functions //
+
+static vector_t *grow(vector_t *my_vec) {
+	size_t data_size_bytes = my_vec->unit_size * my_vec->capacity;
+	size_t old_size_bytes = sizeof(vector_t) + data_size_bytes;
+	size_t new_size_bytes = sizeof(vector_t) + data_size_bytes * 2;
+	vector_t *new_vec = NULL;
+	memory_stats_local()->vector_regrowths++;
+	if(my_vec->arena == NULL) new_vec = realloc(my_vec, new_size_bytes);
+	else if(arena_extend(my_vec->arena, my_vec, old_size_bytes, new_size_bytes)) {
+		memory_stats_local()->vector_regrowths_in_place++;
+		new_vec = my_vec;
+	} else {
+		new_vec = arena_alloc(my_vec->arena, new_size_bytes);
+		error_if(new_vec == NULL);
+		memcpy(new_vec, my_vec, old_size_bytes);
+		memory_stats_local()->arena_wasted += old_size_bytes;
+	}
+	error_if(new_vec == NULL);
+	new_vec->capacity *= 2;
+	return new_vec;
+}
+
+// External Functions //
+
 vector_t *vector_new(arena_t *arena, size_t unit_size, size_t capacity) {
 	size_t initial_size_bytes = sizeof(vector_t) + unit_size * capacity;
 	vector_t *vector;
@@ -18,17 +46,7 @@ vector_t *vector_new(arena_t *arena, size_t unit_size, size_t capacity) {
 
 void vector_add(vector_t **vector, const void *data) {
 	vector_t *my_vec = *vector;
-	if(my_vec->count == my_vec->capacity) {
-		size_t data_size_bytes = my_vec->unit_size * my_vec->capacity;
-		size_t new_size_bytes = sizeof(vector_t) + data_size_bytes * 2;
-		vector_t * new_vec = NULL;
-		if(my_vec->arena != NULL) {
-			new_vec = arena_alloc(my_vec->arena, new_size_bytes);
-			memcpy(new_vec, my_vec, sizeof(vector_t) + data_size_bytes);
-		} else new_vec = realloc(my_vec, new_size_bytes);
-		new_vec->capacity *= 2;
-		my_vec = new_vec;
-	}
+	if(my_vec->count == my_vec->capacity) my_vec = grow(my_vec);
 
 	size_t data_index = (my_vec->count++) * my_vec->unit_size;
 	memcpy(&my_vec->data[data_index], data, my_vec->unit_size);
@@ -50,20 +68,56 @@ void *vector_peek(vector_t *vector) {
 }
 
 void vector_add_to(vector_t **vector, const void *data, size_t index) {
-	(void) vector;
-	(void) data;
-	(void) index;
-	// TODO
+	vector_t *my_vec = *vector;
+	if(index > my_vec->count) index = my_vec->count;
+	if(my_vec->count == my_vec->capacity) my_vec = grow(my_vec);
+
+	// shift everything from the index onwards up by one to make room
+	size_t unit_size = my_vec->unit_size;
+	uint8_t *slot = &my_vec->data[index * unit_size];
+	memmove(slot + unit_size, slot, (my_vec->count - index) * unit_size);
+	memcpy(slot, data, unit_size);
+	my_vec->count++;
+	*vector = my_vec;
 }
 
 void vector_take_from(vector_t *vector, void *data, size_t index) {
-	(void) vector;
-	(void) data;
-	(void) index;
-	// TODO
+	if(index >= vector->count) {
+		memset(data, 0, vector->unit_size);
+		return;
+	}
+
+	// shift everything after the index down by one to fill the gap
+	size_t unit_size = vector->unit_size;
+	uint8_t *slot = &vector->data[index * unit_size];
+	memmove(data, slot, unit_size);
+	memmove(slot, slot + unit_size, (vector->count - index - 1) * unit_size);
+	vector->count--;
 }
 
 void *vector_peek_from(vector_t *vector, size_t index) {
 	if(index >= vector->count) return NULL;
 	return &vector->data[index * vector->unit_size];
 }
+
+void *vector_reserve(arena_t *arena, void *data, size_t old_capacity, size_t new_capacity, size_t unit_size) {
+	size_t old_size_bytes = old_capacity * unit_size;
+	size_t new_size_bytes = new_capacity * unit_size;
+	if(data != NULL) memory_stats_local()->vector_regrowths++;
+	if(arena == NULL) {
+		void *new_data = realloc(data, new_size_bytes);
+		error_if(new_data == NULL);
+		return new_data;
+	}
+
+	if(data != NULL && arena_extend(arena, data, old_size_bytes, new_size_bytes)) {
+		memory_stats_local()->vector_regrowths_in_place++;
+		return data;
+	}
+	void *new_data = arena_alloc(arena, new_size_bytes);
+	error_if(new_data == NULL);
+	if(data != NULL) memcpy(new_data, data, old_size_bytes);
+	// Storage that started out in a buffer of the caller is not wasted
+	if(data != NULL && arena_owns(arena, data)) memory_stats_local()->arena_wasted += old_size_bytes;
+	return new_data;
+}
@@ -1,45 +1,493 @@
+// Needed for clock_gettime, getrusage, open_memstream and sysconf under
+// strict C99
+#define _DEFAULT_SOURCE
+
+#include "common/stats.h"
 #include "common/strslice.h"
 #include "frontend/error.h"
 #include "frontend/lexical/lexer.h"
+#include "frontend/lexical/scan.h"
 #include "frontend/syntactic/ast.h"
+#include "frontend/syntactic/dump.h"
 #include "frontend/syntactic/parser.h"
+#include "frontend/semantic/fold.h"
 #include "frontend/semantic/scope.h"
+#include "frontend/semantic/types.h"
+#include "middle/ir.h"
+#include "middle/lower.h"
 
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef enum phase {
+	PHASE_LEX, PHASE_PARSE, PHASE_SEMA, PHASE_IR, PHASE_COUNT
+} phase_t;
+
+static const char *phase_names[] = {"lex", "parse", "sema", "ir"};
+
+// Everything that is timed, the phases along with the optional steps
+typedef enum timer {
+	TIMER_LEX, TIMER_PARSE, TIMER_DUMP, TIMER_SEMA, TIMER_IR, TIMER_DUMP_IR, TIMER_COUNT
+} timed_step_t;
+
+static const char *timer_names[] = {"lex", "parse", "dump", "sema", "ir", "dump_ir"};
+
+/// The streams each file writes its results to.
+typedef enum stream {
+	/// Tree and IR dumps, standard output unless redirected with `-o`.
+	STREAM_DUMP,
+	/// Errors found in the file, always standard output.
+	STREAM_DIAGNOSTICS,
+	/// Timings and failures to read the file, always standard error.
+	STREAM_MESSAGES,
+	STREAM_COUNT
+} stream_t;
+
+typedef enum stats_format {
+	STATS_NONE, STATS_TABLE, STATS_JSON
+} stats_format_t;
+
+/// What the `--stats` report is made of, summed over all files.
+typedef struct run_stats {
+	size_t files;
+	size_t bytes;
+	size_t tokens;
+	size_t symbols;
+	double times[TIMER_COUNT];
+	size_t nodes[AST_NODE_COUNT];
+	size_t ir_blocks;
+	size_t ir_insts;
+	memory_stats_t memory;
+} run_stats_t;
+
+/// A single line of the report, those of a group are reported together.
+typedef struct stat_entry {
+	const char *group;
+	const char *name;
+	double value;
+	bool integer;
+} stat_entry_t;
+
+typedef struct options {
+	/// The last phase to run on each file.
+	phase_t stop_after;
+	bool dump_ast;
+	ast_dump_format_t dump_format;
+	bool dump_ir;
+	bool time_phases;
+	stats_format_t stats;
+	/// How many files are compiled at once.
+	size_t jobs;
+	/// How many errors a file can have before giving up on it, 0 for any.
+	size_t max_errors;
+	/// Where dumps are written to, standard output if `NULL`.
+	const char *output;
+	/// The files to compile, in the order they were given.
+	char **inputs;
+	size_t input_count;
+} options_t;
+
+/// A file handed to the workers and what came out of compiling it.
+typedef struct job {
+	const char *path;
+	bool done;
+	bool success;
+	run_stats_t stats;
+	/// The output of each stream, held back to be written in input order.
+	char *output[STREAM_COUNT];
+	size_t output_size[STREAM_COUNT];
+} job_t;
+
+/// The state shared by the workers, the lock guards `next` and `done`.
+typedef struct pool {
+	const options_t *options;
+	job_t *jobs;
+	size_t next;
+	pthread_mutex_t lock;
+	/// Signalled every time a job is done.
+	pthread_cond_t finished;
+} pool_t;
+
+// Internal Functions //
+
+static void usage(FILE *stream, const char *program) {
+	fprintf(stream,
+		"Usage: %s [options] <file>...\n"
+		"Options:\n"
+		"  --stop-after=<phase>  Stop after lex, parse, sema or ir (the default)\n"
+		"  --dump-ast[=<format>] Write out the tree as tree, sexpr or json\n"
+		"  --dump-ir             Write out the IR of files without errors\n"
+		"  --time-phases         Report how long each phase took per file\n"
+		"  --stats[=<format>]    Report totals as a table or as json\n"
+		"  -j, --jobs=<count>    Use that many threads at most, 0 for one per core\n"
+		"  --max-errors=<count>  Give up on a file after that many errors (20),\n"
+		"                        0 for no limit\n"
+		"  -o <file>             Write dumps to a file instead of stdout\n"
+		"  -h, --help            Show this message\n"
+		"A file named \"-\" is read from the standard input.\n",
+		program
+	);
+}
+
+static void bad_usage(const char *program, const char *problem, const char *arg) {
+	fprintf(stderr, "%s: %s \"%s\"\n", program, problem, arg);
+	usage(stderr, program);
+	exit(EXIT_FAILURE);
+}
+
+static bool parse_phase(const char *name, phase_t *phase) {
+	for(size_t i=0; i<PHASE_COUNT; i++) if(strcmp(name, phase_names[i]) == 0) {
+		*phase = (phase_t) i;
+		return true;
+	}
+	return false;
+}
+
+static bool parse_count(const char *count, size_t *value) {
+	char *end;
+	long parsed = strtol(count, &end, 10);
+	if(end == count || *end != '\0' || parsed < 0) return false;
+	*value = (size_t) parsed;
+	return true;
+}
+
+static bool parse_jobs(const char *count, size_t *jobs) {
+	if(!parse_count(count, jobs)) return false;
+	if(*jobs == 0) {
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		*jobs = cores < 1 ? 1 : (size_t) cores;
+	}
+	return true;
+}
+
+static options_t parse_options(int argc, char **argv) {
+	options_t options = {
+		.stop_after = PHASE_IR,
+		.dump_ast = false, .dump_format = AST_DUMP_TREE, .dump_ir = false,
+		.time_phases = false, .stats = STATS_NONE, .jobs = 1, .max_errors = 20, .output = NULL,
+		.inputs = (char **) malloc(argc * sizeof(char *)),
+		.input_count = 0
+	};
+	error_if(options.inputs == NULL);
+
+	bool only_inputs = false;
+	for(int i=1; i<argc; i++) {
+		char *arg = argv[i];
+		if(only_inputs || arg[0] != '-' || strcmp(arg, "-") == 0)
+			options.inputs[options.input_count++] = arg;
+		else if(strcmp(arg, "--") == 0) only_inputs = true;
+		else if(strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+			usage(stdout, argv[0]);
+			exit(EXIT_SUCCESS);
+		} else if(strncmp(arg, "--stop-after=", 13) == 0) {
+			if(!parse_phase(&arg[13], &options.stop_after))
+				bad_usage(argv[0], "unknown phase", &arg[13]);
+		} else if(strcmp(arg, "--dump-ast") == 0) options.dump_ast = true;
+		else if(strncmp(arg, "--dump-ast=", 11) == 0) {
+			options.dump_ast = true;
+			if(!ast_dump_parse_format(&arg[11], &options.dump_format))
+				bad_usage(argv[0], "unknown dump format", &arg[11]);
+		} else if(strcmp(arg, "--dump-ir") == 0) options.dump_ir = true;
+		else if(strcmp(arg, "--time-phases") == 0) options.time_phases = true;
+		else if(strcmp(arg, "--stats") == 0 || strcmp(arg, "--stats=table") == 0)
+			options.stats = STATS_TABLE;
+		else if(strcmp(arg, "--stats=json") == 0) options.stats = STATS_JSON;
+		else if(strncmp(arg, "--stats=", 8) == 0)
+			bad_usage(argv[0], "unknown stats format", &arg[8]);
+		else if(strcmp(arg, "-j") == 0) {
+			if(i + 1 == argc) bad_usage(argv[0], "missing count after", arg);
+			if(!parse_jobs(argv[++i], &options.jobs))
+				bad_usage(argv[0], "invalid job count", argv[i]);
+		} else if(strncmp(arg, "-j", 2) == 0 && arg[2] != '-') {
+			if(!parse_jobs(&arg[2], &options.jobs))
+				bad_usage(argv[0], "invalid job count", &arg[2]);
+		} else if(strncmp(arg, "--jobs=", 7) == 0) {
+			if(!parse_jobs(&arg[7], &options.jobs))
+				bad_usage(argv[0], "invalid job count", &arg[7]);
+		} else if(strncmp(arg, "--max-errors=", 13) == 0) {
+			if(!parse_count(&arg[13], &options.max_errors))
+				bad_usage(argv[0], "invalid error count", &arg[13]);
+		} else if(strcmp(arg, "-o") == 0) {
+			if(i + 1 == argc) bad_usage(argv[0], "missing file after", arg);
+			options.output = argv[++i];
+		} else bad_usage(argv[0], "unknown option", arg);
+	}
+
+	if(options.input_count == 0) {
+		usage(stderr, argv[0]);
+		exit(EXIT_FAILURE);
+	}
+	if(options.dump_ast && options.stop_after < PHASE_PARSE)
+		bad_usage(argv[0], "the tree is never built with", "--stop-after=lex");
+	if(options.dump_ir && options.stop_after < PHASE_IR)
+		bad_usage(argv[0], "the IR is never built with", phase_names[options.stop_after]);
+	return options;
+}
+
+static double now_ms(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1e3 + time.tv_nsec / 1e6;
+}
+
+static void add_stats(run_stats_t *total, const run_stats_t *part) {
+	total->files += part->files;
+	total->bytes += part->bytes;
+	total->tokens += part->tokens;
+	total->symbols += part->symbols;
+	for(size_t i=0; i<TIMER_COUNT; i++) total->times[i] += part->times[i];
+	for(size_t i=0; i<AST_NODE_COUNT; i++) total->nodes[i] += part->nodes[i];
+	total->ir_blocks += part->ir_blocks;
+	total->ir_insts += part->ir_insts;
+	memory_stats_t none = {0};
+	memory_stats_accumulate(&total->memory, &none, &part->memory);
+}
+
+static void print_stats(const run_stats_t *stats, stats_format_t format, FILE *stream) {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	size_t total_nodes = 0;
+	for(size_t i=0; i<AST_NODE_COUNT; i++) total_nodes += stats->nodes[i];
+
+	stat_entry_t entries[16 + TIMER_COUNT + AST_NODE_COUNT];
+	size_t count = 0;
+	#define ENTRY(m_group, m_name, m_value, m_integer) entries[count++] = \
+		(stat_entry_t) {.group = m_group, .name = m_name, .value = m_value, .integer = m_integer}
+	ENTRY(NULL, "files", stats->files, true);
+	ENTRY(NULL, "bytes", stats->bytes, true);
+	ENTRY(NULL, "tokens", stats->tokens, true);
+	ENTRY(NULL, "symbols", stats->symbols, true);
+	for(size_t i=0; i<TIMER_COUNT; i++) ENTRY("time_ms", timer_names[i], stats->times[i], false);
+	ENTRY("nodes", "total", total_nodes, true);
+	for(size_t i=0; i<AST_NODE_COUNT; i++)
+		if(stats->nodes[i] > 0) ENTRY("nodes", node_type_strs[i], stats->nodes[i], true);
+	ENTRY("ir", "blocks", stats->ir_blocks, true);
+	ENTRY("ir", "instructions", stats->ir_insts, true);
+	ENTRY("memory", "arena_requested", stats->memory.arena_requested, true);
+	ENTRY("memory", "arena_reserved", stats->memory.arena_reserved, true);
+	ENTRY("memory", "arena_wasted", stats->memory.arena_wasted, true);
+	ENTRY("memory", "arena_regions", stats->memory.arena_regions, true);
+	ENTRY("memory", "vector_regrowths", stats->memory.vector_regrowths, true);
+	ENTRY("memory", "vector_regrowths_in_place", stats->memory.vector_regrowths_in_place, true);
+	// Linux reports the peak resident set size in kilobytes
+	ENTRY("memory", "peak_rss_kib", usage.ru_maxrss, true);
+	#undef ENTRY
+
+	const char *group = NULL;
+	if(format == STATS_JSON) fputc('{', stream);
+	for(size_t i=0; i<count; i++) {
+		stat_entry_t *entry = &entries[i];
+		bool same_group = group == entry->group
+			|| (group != NULL && entry->group != NULL && strcmp(group, entry->group) == 0);
+		if(format == STATS_JSON) {
+			// Groups become nested objects
+			if(!same_group && group != NULL) fputc('}', stream);
+			if(i > 0) fputc(',', stream);
+			if(!same_group && entry->group != NULL) fprintf(stream, "\"%s\":{", entry->group);
+			fprintf(stream, "\"%s\":", entry->name);
+			if(entry->integer) fprintf(stream, "%zu", (size_t) entry->value);
+			else fprintf(stream, "%.3f", entry->value);
+		} else {
+			char name[64];
+			if(entry->group == NULL) snprintf(name, sizeof name, "%s", entry->name);
+			else snprintf(name, sizeof name, "%s.%s", entry->group, entry->name);
+			if(entry->integer) fprintf(stream, "%-32s %16zu\n", name, (size_t) entry->value);
+			else fprintf(stream, "%-32s %16.3f\n", name, entry->value);
+		}
+		group = entry->group;
+	}
+	if(format == STATS_JSON) fputs(group != NULL ? "}}\n" : "}\n", stream);
+}
+
+/** Runs the phases on a single file up to the one chosen by the options.
+  * Only touches state of its own, so files can be compiled on any thread.
+  * @param streams Where to write the results to, indexed by `stream_t`.
+  * @param stats Where to add the figures of the file to.
+  * @return Whether the file compiled without any errors.
+  */
+static bool compile(const char *path, const options_t *options, FILE *streams[], run_stats_t *stats) {
+	memory_stats_t memory_before = *memory_stats_local();
+	string_file_t file = str_file_load(path);
+	if(file.content.string == NULL) {
+		fprintf(streams[STREAM_MESSAGES], "%s: %s\n", path, strerror(errno));
+		return false;
+	}
+
+	double times[TIMER_COUNT] = {0};
+	bool timed[TIMER_COUNT] = {false};
+	#define TIME(m_timer, m_code) do { \
+		double start = now_ms(); m_code; \
+		times[m_timer] = now_ms() - start, timed[m_timer] = true; \
+	} while(0)
+
+	error_sink_t errors;
+	err_init(&errors);
+	errors.limit = options->max_errors;
+	lexer_t lexer;
+	// The threads are only spent on lexing when there are no other files
+	size_t lex_threads = options->input_count == 1 ? options->jobs : 1;
+	TIME(TIMER_LEX, lexer_init(&lexer, file, &errors, lex_threads));
+
+	ast_t ast = ast_tree_new(lexer_get_tokens(&lexer), file.content);
+	bool complete = false;
+	// Lexing can use up all of the errors a file is allowed
+	if(options->stop_after >= PHASE_PARSE && !errors.fatal) {
+		TIME(TIMER_PARSE, complete = parser_run(&lexer, &errors, &ast));
+		if(options->dump_ast && complete)
+			TIME(TIMER_DUMP, ast_dump(&ast, streams[STREAM_DUMP], options->dump_format));
+	}
+	// The invalid characters are reported as the parser gets to them, the
+	// ones it did not get to still count unless the limit was reached
+	lexer_report_invalid(&lexer);
+
+	// A tree cut short by a fatal error has nothing to check
+	size_t symbol_count = intern_count(lexer_get_symbols(&lexer));
+	if(options->stop_after >= PHASE_SEMA && complete) TIME(TIMER_SEMA,
+		scope_run(file, &ast, symbol_count, &errors);
+		types_run(file, &ast, &errors);
+		fold_run(file, &ast, &errors));
+
+	// Only a tree that passed every check means something to lower
+	if(options->stop_after >= PHASE_IR && complete && err_count(&errors) == 0) {
+		ir_t ir;
+		TIME(TIMER_IR, ir_init(&ir, &ast); lower_run(&ast, &ir));
+		if(options->dump_ir && err_count(&errors) == 0)
+			TIME(TIMER_DUMP_IR, ir_dump(&ir, streams[STREAM_DUMP]));
+		stats->ir_blocks += ir.blocks.count;
+		// The first instruction is the placeholder of `IR_NONE`
+		stats->ir_insts += ir.insts.count - 1;
+		ir_free(&ir);
+	}
+	#undef TIME
+
+	if(options->time_phases) {
+		FILE *messages = streams[STREAM_MESSAGES];
+		fprintf(messages, "%s:", path);
+		const char *separator = " ";
+		for(size_t i=0; i<TIMER_COUNT; i++) if(timed[i]) {
+			fprintf(messages, "%s%s %.3f ms", separator, timer_names[i], times[i]);
+			separator = ", ";
+		}
+		fputc('\n', messages);
+	}
+
+	stats->files++;
+	// The terminator is counted in the size of the contents
+	stats->bytes += file.content.size - 1;
+	stats->tokens += lexer_get_tokens(&lexer)->count;
+	stats->symbols += symbol_count;
+	for(size_t i=0; i<TIMER_COUNT; i++) stats->times[i] += times[i];
+	// The first node is the placeholder of `AST_NONE`
+	for(size_t i=1; i<ast.nodes.count; i++) stats->nodes[ast.nodes.data[i].type]++;
+
+	ast_tree_free(&ast);
+	lexer_free(&lexer);
+	bool success = err_count(&errors) == 0;
+	err_finalize(&errors, streams[STREAM_DIAGNOSTICS]);
+	str_file_free(&file);
+	memory_stats_accumulate(&stats->memory, &memory_before, memory_stats_local());
+	return success;
+}
+
+static void *worker(void *argument) {
+	pool_t *pool = (pool_t *) argument;
+	for(;;) {
+		pthread_mutex_lock(&pool->lock);
+		size_t index = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+		if(index >= pool->options->input_count) return NULL;
+
+		job_t *job = &pool->jobs[index];
+		FILE *streams[STREAM_COUNT];
+		for(size_t i=0; i<STREAM_COUNT; i++) {
+			streams[i] = open_memstream(&job->output[i], &job->output_size[i]);
+			error_if(streams[i] == NULL);
+		}
+		job->success = compile(job->path, pool->options, streams, &job->stats);
+		for(size_t i=0; i<STREAM_COUNT; i++) error_if(fclose(streams[i]) != 0);
+
+		pthread_mutex_lock(&pool->lock);
+		job->done = true;
+		pthread_cond_broadcast(&pool->finished);
+		pthread_mutex_unlock(&pool->lock);
+	}
+}
+
+/** Compiles the files on a pool of threads. Each file is written out as soon
+  * as it and every file before it are done, so the output is the same as
+  * that of compiling the files one after the other.
+  */
+static bool compile_parallel(const options_t *options, FILE *streams[], run_stats_t *stats) {
+	pool_t pool = {.options = options, .next = 0};
+	pool.jobs = (job_t *) calloc(options->input_count, sizeof(job_t));
+	error_if(pool.jobs == NULL);
+	for(size_t i=0; i<options->input_count; i++) pool.jobs[i].path = options->inputs[i];
+	error_if(pthread_mutex_init(&pool.lock, NULL) != 0);
+	error_if(pthread_cond_init(&pool.finished, NULL) != 0);
+
+	size_t thread_count = options->jobs < options->input_count ? options->jobs : options->input_count;
+	pthread_t *threads = (pthread_t *) malloc(thread_count * sizeof(pthread_t));
+	error_if(threads == NULL);
+	for(size_t i=0; i<thread_count; i++)
+		error_if(pthread_create(&threads[i], NULL, worker, &pool) != 0);
+
+	bool success = true;
+	for(size_t i=0; i<options->input_count; i++) {
+		job_t *job = &pool.jobs[i];
+		pthread_mutex_lock(&pool.lock);
+		while(!job->done) pthread_cond_wait(&pool.finished, &pool.lock);
+		pthread_mutex_unlock(&pool.lock);
+
+		for(size_t j=0; j<STREAM_COUNT; j++) {
+			size_t size = job->output_size[j];
+			error_if(fwrite(job->output[j], 1, size, streams[j]) != size);
+			free(job->output[j]);
+		}
+		success &= job->success;
+		add_stats(stats, &job->stats);
+	}
+
+	for(size_t i=0; i<thread_count; i++) error_if(pthread_join(threads[i], NULL) != 0);
+	pthread_cond_destroy(&pool.finished);
+	pthread_mutex_destroy(&pool.lock);
+	free(threads);
+	free(pool.jobs);
+	return success;
+}
+
+// External Functions //
 
 int main(int argc, char **argv) {
 	// I will keep this here for my future self to laugh at.
 	// The C99 standard guarantees chars to be of size 1.
 	// assert(sizeof(char) == 1);
-	if(argc != 2) exit(EXIT_FAILURE);
-
-	FILE *fdesc = fopen(argv[1], "r");
-	error_if(!fdesc);
-	string_file_t file;
-	file.name.string = argv[1];
-	file.name.size = strlen(argv[1]);
-	file.content = str_read(fdesc);
-	file.lines = str_count_lines(file.content);
-	error_if(!file.content.string);
-	fclose(fdesc);
-
-	{
-		err_init();
-
-		lexer_init(file);
-		
-		ast_t ast = ast_tree_new();
-		parser_run(file, &ast);
-		ast_tree_visualize(&ast);
-		
-		scope_run(&ast);
-
-		ast_tree_free(&ast);
-		err_finalize();
-	}
-
-	free(file.content.string);
-	exit(EXIT_SUCCESS);
+	options_t options = parse_options(argc, argv);
+
+	FILE *output = stdout;
+	if(options.output != NULL) {
+		output = fopen(options.output, "w");
+		if(output == NULL) perror(options.output), exit(EXIT_FAILURE);
+	}
+
+	scan_init();
+	bool success = true;
+	run_stats_t stats = {0};
+	FILE *streams[STREAM_COUNT] = {output, stdout, stderr};
+	if(options.jobs > 1 && options.input_count > 1)
+		success = compile_parallel(&options, streams, &stats);
+	else for(size_t i=0; i<options.input_count; i++)
+		success &= compile(options.inputs[i], &options, streams, &stats);
+	if(options.stats != STATS_NONE) print_stats(&stats, options.stats, stderr);
+
+	if(output != stdout) error_if(fclose(output) != 0);
+	free(options.inputs);
+	exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
 }
@@ -1,17 +1,8 @@
 #include "error.h"
 
-#include "common/vector.h"
-
-#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-static struct error_state {
-	bool init;
-	arena_t arena;
-	vector_t *vector;
-} es = {.init = false};
-
 // Internal Functions //
 
 static unsigned digit_count(unsigned num) {
@@ -20,70 +11,67 @@ static unsigned digit_count(unsigned num) {
 	return ret;
 }
 
-static string_t get_line(string_t full, unsigned line) {
-	string_t ret = EMPTY_STRING;
-	ret.string = full.string - 1;
-	size_t i = 0;
-	for(; i<full.size && line > 0; i++) {
-		char *ptr = &full.string[i];
-		if(*ptr == '\n') line--, ret.string = ptr;
-	}
-	if(line != 0) return EMPTY_STRING;
-	ret.string++;
-	for(; i<full.size; i++) {
-		char *ptr = &full.string[i];
-		if(*ptr == '\n') break;
-		ret.size++;
-	}
-	return ret;
-}
-
-static void cleanup(void) {
-	assert(es.init);
-	arena_free(&es.arena);
-	es.init = false;
+static int compare_spots(const void *a, const void *b) {
+	const error_t *left = *(const error_t *const *) a, *right = *(const error_t *const *) b;
+	if(left->row != right->row) return left->row < right->row ? -1 : 1;
+	if(left->column != right->column) return left->column < right->column ? -1 : 1;
+	// Errors at the same spot stay in the order they were submitted in,
+	// which is the order they are laid out in the list
+	return left < right ? -1 : left > right;
 }
 
 // External Functions //
 
-void err_init(void) {
-	if(es.init) cleanup();
-	es.arena = arena_new(1024);
-	es.vector = vector_new(&es.arena, sizeof(error_t), 16);
-	es.init = true;
+void err_init(error_sink_t *sink) {
+	sink->arena = arena_new(1024);
+	sink->errors = error_list_new(&sink->arena, 16);
+	sink->bail = NULL;
+	sink->fatal = false;
+	sink->limit = 0;
 }
 
-arena_t *err_get_arena(void) {
-	if(!es.init) return NULL;
-	else return &es.arena;
+arena_t *err_get_arena(error_sink_t *sink) {
+	return &sink->arena;
 }
 
 error_t err_new(string_file_t file, string_t spot, string_t message) {
-	size_t line = 0;
-	char *content = file.content.string;
-	char *last_nl = content - 1;
-
-	for(char *c = content; c < spot.string; c++)
-		if(*c == '\n') line++, last_nl = c;
-
+	unsigned row, column;
+	str_file_locate(&file, spot.string, &row, &column);
 	return (error_t) {
-		.file = file, .row = line,
-		.column = spot.string - last_nl - 1,
+		.file = file, .row = row,
+		.column = column,
 		.length = spot.size,
 		.message = message
 	};
 }
 
-void err_submit(error_t error, bool fatal) {
-	assert(es.init);
-	vector_add(&es.vector, &error);
-	if(fatal) err_finalize(), exit(EXIT_FAILURE);
+void err_submit(error_sink_t *sink, error_t error, bool fatal) {
+	if(err_full(sink)) return;
+	error_list_push(&sink->errors, error);
+	if(err_full(sink)) fatal = true;
+	if(!fatal) return;
+	sink->fatal = true;
+	if(sink->bail != NULL) longjmp(*sink->bail, 1);
+}
+
+size_t err_count(const error_sink_t *sink) {
+	return sink->errors.count;
+}
+
+bool err_full(const error_sink_t *sink) {
+	return sink->limit != 0 && sink->errors.count >= sink->limit;
 }
 
-void err_finalize(void) {
-	for(size_t i = 0; i < es.vector->count; i++) {
-		error_t *error = vector_peek_from(es.vector, i);
-		printf(
+void err_finalize(error_sink_t *sink, FILE *stream) {
+	// Phases report in the order they run, the errors are shown in the order
+	// of where they are in the file
+	error_t **sorted = arena_alloc(&sink->arena, sink->errors.count * sizeof(error_t *));
+	for(size_t i = 0; i < sink->errors.count; i++) sorted[i] = &sink->errors.data[i];
+	qsort(sorted, sink->errors.count, sizeof(error_t *), compare_spots);
+
+	for(size_t i = 0; i < sink->errors.count; i++) {
+		error_t *error = sorted[i];
+		fprintf(stream,
 			"\x1b[1;31mERROR:\x1b[37m %.*s at line %u, column %u\x1b[0m\n",
 			(int) error->file.name.size,
 			error->file.name.string,
@@ -95,19 +83,19 @@ void err_finalize(void) {
 		unsigned max_line = error->row + LINE_SPAN;
 		if(max_line >= error->file.lines) max_line = error->file.lines - 1;
 		for(unsigned lnum = min_line; lnum <= max_line; lnum++) {
-			string_t line = get_line(error->file.content, lnum);
-			printf(
+			string_t line = str_file_get_line(&error->file, lnum);
+			fprintf(stream,
 				" \x1b[1;36m%.*d |\x1b[0m %.*s\n",
 				(int) digits, lnum + 1,
 				(int) line.size, line.string
 			);
 			if(lnum == error->row) {
-				for(unsigned i=0; i<digits+2; i++) putchar(' ');
-				printf("\x1b[1;36m|\x1b[0m");
-				for(unsigned i=0; i<error->column+1; i++) putchar(' ');
-				printf("\x1b[1;35m^");
-				for(size_t i=0; i<error->length-1; i++) putchar('~');
-				printf(
+				for(unsigned i=0; i<digits+2; i++) fputc(' ', stream);
+				fputs("\x1b[1;36m|\x1b[0m", stream);
+				for(unsigned i=0; i<error->column+1; i++) fputc(' ', stream);
+				fputs("\x1b[1;35m^", stream);
+				for(size_t i=0; i<error->length-1; i++) fputc('~', stream);
+				fprintf(stream,
 					" %.*s\x1b[0m\n",
 					(int) error->message.size,
 					error->message.string
@@ -115,7 +103,14 @@ void err_finalize(void) {
 			}
 		}
 	}
-	cleanup();
+	if(sink->limit != 0 && sink->errors.count == sink->limit) {
+		string_t name = sink->errors.data[0].file.name;
+		fprintf(stream,
+			"\x1b[1;31mERROR:\x1b[37m %.*s has too many errors, stopped after %zu\x1b[0m\n",
+			(int) name.size, name.string, sink->limit
+		);
+	}
+	arena_free(&sink->arena);
 }
 
 void error_if(bool error_condition) {
@@ -0,0 +1,28 @@
+#include "charclass.h"
+
+#define IDENT (CHAR_IDENT_START | CHAR_IDENT_PART)
+#define DIGIT (CHAR_DIGIT | CHAR_IDENT_PART)
+
+// Every character is spelled out, C99 has no designators for ranges
+const uint8_t char_classes[256] = {
+	['a'] = IDENT, ['b'] = IDENT, ['c'] = IDENT, ['d'] = IDENT, ['e'] = IDENT, ['f'] = IDENT, ['g'] = IDENT,
+	['h'] = IDENT, ['i'] = IDENT, ['j'] = IDENT, ['k'] = IDENT, ['l'] = IDENT, ['m'] = IDENT, ['n'] = IDENT,
+	['o'] = IDENT, ['p'] = IDENT, ['q'] = IDENT, ['r'] = IDENT, ['s'] = IDENT, ['t'] = IDENT, ['u'] = IDENT,
+	['v'] = IDENT, ['w'] = IDENT, ['x'] = IDENT, ['y'] = IDENT, ['z'] = IDENT,
+	['A'] = IDENT, ['B'] = IDENT, ['C'] = IDENT, ['D'] = IDENT, ['E'] = IDENT, ['F'] = IDENT, ['G'] = IDENT,
+	['H'] = IDENT, ['I'] = IDENT, ['J'] = IDENT, ['K'] = IDENT, ['L'] = IDENT, ['M'] = IDENT, ['N'] = IDENT,
+	['O'] = IDENT, ['P'] = IDENT, ['Q'] = IDENT, ['R'] = IDENT, ['S'] = IDENT, ['T'] = IDENT, ['U'] = IDENT,
+	['V'] = IDENT, ['W'] = IDENT, ['X'] = IDENT, ['Y'] = IDENT, ['Z'] = IDENT,
+	['_'] = IDENT,
+	['0'] = DIGIT, ['1'] = DIGIT, ['2'] = DIGIT, ['3'] = DIGIT, ['4'] = DIGIT,
+	['5'] = DIGIT, ['6'] = DIGIT, ['7'] = DIGIT, ['8'] = DIGIT, ['9'] = DIGIT,
+
+	[' '] = CHAR_WHITE_SPACE, ['\t'] = CHAR_WHITE_SPACE,
+	['\r'] = CHAR_WHITE_SPACE, ['\n'] = CHAR_WHITE_SPACE,
+
+	['('] = CHAR_SYMBOL, [')'] = CHAR_SYMBOL,
+	[','] = CHAR_SYMBOL, [':'] = CHAR_SYMBOL, [';'] = CHAR_SYMBOL,
+	['='] = CHAR_SYMBOL, ['+'] = CHAR_SYMBOL, ['-'] = CHAR_SYMBOL,
+	['*'] = CHAR_SYMBOL, ['/'] = CHAR_SYMBOL, ['%'] = CHAR_SYMBOL,
+	['<'] = CHAR_SYMBOL, ['>'] = CHAR_SYMBOL
+};
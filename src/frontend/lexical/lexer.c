@@ -1,16 +1,22 @@
 #include "lexer.h"
 
-#include "common/arena.h"
+#include "charclass.h"
+#include "scan.h"
+
+#include "common/stats.h"
 #include "common/strslice.h"
+#include "common/vector.h"
 #include "frontend/error.h"
 
-#include <ctype.h>
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include "keywords.c"
+#include "frontend/lexical/keywords.c"
 
 const char *token_type_strs[] = {
 	"ERROR", "EOF",
@@ -27,209 +33,360 @@ const char *token_type_strs[] = {
 	"an identifier", "an integer literal"
 };
 
-static struct lexer_state {
-	bool reinit;
+// The token types of every symbol on its own and when followed by "=",
+// `TOK_ERROR` marks that the symbol does not combine with "="
+static const struct symbol_tokens {
+	uint8_t alone;
+	uint8_t with_equals;
+} symbol_tokens[256] = {
+	['('] = {TOK_OPEN_ROUND, TOK_ERROR}, [')'] = {TOK_CLOSE_ROUND, TOK_ERROR},
+	[','] = {TOK_COMMA, TOK_ERROR}, [':'] = {TOK_COLON, TOK_ERROR},
+	[';'] = {TOK_SEMICOLON, TOK_ERROR}, ['='] = {TOK_OP_ASSIGN, TOK_OP_COMPARE},
+	['+'] = {TOK_OP_PLUS, TOK_OP_ASSIGN_ALT}, ['-'] = {TOK_OP_MINUS, TOK_OP_ASSIGN_ALT},
+	['*'] = {TOK_OP_MULT, TOK_OP_ASSIGN_ALT}, ['/'] = {TOK_OP_DIV, TOK_OP_ASSIGN_ALT},
+	['%'] = {TOK_OP_MOD, TOK_OP_ASSIGN_ALT}, ['<'] = {TOK_OP_COMPARE, TOK_OP_COMPARE},
+	['>'] = {TOK_OP_COMPARE, TOK_OP_COMPARE}
+};
 
-	string_file_t file;
-	size_t file_ptr;
+// Files are only split into chunks at least this big, smaller ones are not
+// worth starting threads for
+#define CHUNK_MIN_SIZE (128 * 1024)
 
-	arena_t list;
-	token_list_t *next_ptr;
-	token_list_t *last_ptr;
-} ls;
+/** A stretch of the file that is lexed on its own, possibly on another
+  * thread. Chunks start right after a newline, which is always between
+  * tokens unless it is inside a block comment. Every chunk but the first
+  * guesses that it is not and the guess is checked once all are done.
+  */
+typedef struct chunk {
+	const char *begin;
+	/// The offset lexing starts at.
+	size_t start;
+	/// Tokens starting at or past this offset belong to the next chunk.
+	size_t end;
+	/// The tokens of the chunk, without their symbols.
+	token_buffer_t tokens;
+	/// The offsets of the invalid characters met along the way.
+	offset_list_t invalid;
+	/// The offset of the first token found, whether it was kept or not.
+	size_t first;
+	/// The offset of the first token of the next chunk.
+	size_t resume;
+	/// What lexing the chunk on a thread of its own did to the memory stats
+	/// of that thread, to be added to the stats of the thread that joins it.
+	memory_stats_t memory;
+} chunk_t;
 
 // Internal Functions //
 
-static bool is_white_space(char c) {
-	switch(c) {
-		case ' ' : case '\t':
-		case '\r': case '\n':
-			return true;
-		default:
-			return false;
+#define RET(x,n) do { *cursor_ptr = cursor, *length = n; return x; } while(0)
+static token_type_t read_token(chunk_t *chunk, const char **cursor_ptr, size_t *length) {
+	// The contents are null-terminated and padded so there is no need to
+	// check the bounds, the terminator stops every scan before the end
+	const char *cursor = *cursor_ptr;
+
+	// Skip whitespaces and comments
+	while(true) {
+		cursor = scan_space(cursor);
+		if(cursor[0] != '/') break;
+		if(cursor[1] == '/') cursor = scan_line_end(cursor + 2);
+		else if(cursor[1] == '*') {
+			cursor = scan_comment_end(cursor + 2);
+			if(*cursor != '\0') cursor += 2;
+		} else break;
+	}
+
+	// Handle symbols and symbol sequences
+	char current = cursor[0], lookahead = cursor[1];
+	if(char_is(current, CHAR_SYMBOL)) {
+		const struct symbol_tokens *symbol = &symbol_tokens[(uint8_t) current];
+		if(lookahead == '=' && symbol->with_equals != TOK_ERROR) RET(symbol->with_equals, 2);
+		else if(current == '<' && lookahead == '>') RET(TOK_OP_COMPARE, 2);
+		else RET(symbol->alone, 1);
 	}
-}
 
-static bool is_ident_part(char c) {
-	if(c == '_') return true;
-	return isalnum(c);
+	if(char_is(current, CHAR_DIGIT)) {
+		// Handle integer literals
+		size_t count = scan_ident(cursor + 1) - cursor;
+		RET(TOK_LIT_NUM, count);
+	} else if(char_is(current, CHAR_IDENT_START)) {
+		// Handle identifiers and keywords
+		size_t count = scan_ident(cursor + 1) - cursor;
+		if(count > KEYWORD_MAX_LENGTH) RET(TOK_IDENT, count);
+		// The padding makes reading a whole word past the end safe
+		uint64_t word;
+		memcpy(&word, cursor, sizeof(uint64_t));
+		word &= keyword_masks[count];
+		size_t slot = KEYWORD_HASH(word);
+		if(keyword_words[slot] == word) RET(keyword_types[slot], count);
+		else RET(TOK_IDENT, count);
+	} else if(current != '\0') {
+		// Only reported once it is sure that the chunk was lexed right
+		offset_list_push(&chunk->invalid, (uint32_t) (cursor - chunk->begin));
+		*cursor_ptr = cursor + 1;
+		return read_token(chunk, cursor_ptr, length);
+	} else RET(TOK_EOF, 1);
 }
+#undef RET
+
+static void add_token(token_buffer_t *tokens, token_type_t type, size_t start, size_t length) {
+	if(tokens->count == tokens->capacity) {
+		if(tokens->capacity != 0) memory_stats_local()->vector_regrowths++;
+		tokens->capacity = tokens->capacity == 0 ? 64 : tokens->capacity * 2;
+		tokens->types = realloc(tokens->types, tokens->capacity * sizeof(uint8_t));
+		tokens->starts = realloc(tokens->starts, tokens->capacity * sizeof(uint32_t));
+		tokens->lengths = realloc(tokens->lengths, tokens->capacity * sizeof(uint32_t));
+		error_if(!tokens->types || !tokens->starts || !tokens->lengths);
+	}
 
-static char get_char(bool consume) {
-	if(ls.file_ptr >= ls.file.content.size) return '\0';
-	char c = ls.file.content.string[ls.file_ptr];
-	if(consume) ls.file_ptr++;
-	return c;
+	size_t index = tokens->count++;
+	tokens->types[index] = (uint8_t) type;
+	tokens->starts[index] = (uint32_t) start;
+	tokens->lengths[index] = (uint32_t) length;
 }
 
-static char skip_until(char c) {
+static void lex_chunk(chunk_t *chunk) {
+	const char *cursor = &chunk->begin[chunk->start];
+	chunk->first = SIZE_MAX;
 	while(true) {
-		char next = get_char(true);
-		if(next == c) return get_char(true);
-		else if(next == '\0') return next;
+		size_t length;
+		token_type_t type = read_token(chunk, &cursor, &length);
+		size_t start = cursor - chunk->begin;
+		if(chunk->first == SIZE_MAX) chunk->first = start;
+		if(start >= chunk->end) {
+			chunk->resume = start;
+			break;
+		}
+		add_token(&chunk->tokens, type, start, length);
+		// The terminator is never consumed, it is its own token
+		if(type == TOK_EOF) break;
+		cursor += length;
 	}
 }
 
-static void cleanup(void) {
-	arena_free(&ls.list);
+static void *lex_chunk_thread(void *chunk) {
+	memory_stats_t before = *memory_stats_local();
+	lex_chunk((chunk_t *) chunk);
+	memory_stats_accumulate(&((chunk_t *) chunk)->memory, &before, memory_stats_local());
+	return NULL;
 }
 
-#define RET(x,n) return (token_t) { .type = x,\
-.content = CONSTRUCT_STR(n, &ls.file.content.string[ls.file_ptr - n]) }
-static token_t read_token(void) {
-	char current = get_char(true);
+static void chunk_free_tokens(chunk_t *chunk) {
+	free(chunk->tokens.types);
+	free(chunk->tokens.starts);
+	free(chunk->tokens.lengths);
+	chunk->tokens = (token_buffer_t) {0};
+}
 
-	// Skip whitespaces and comments
-	while(true) {
-		if(current == '/') {
-			char lookahead = get_char(false);
-			if(lookahead == '/') current = skip_until('\n');
-			else if(lookahead == '*') {
-				do current = skip_until('*');
-				while(current != '/' && current != '\0');
-				current = get_char(true);
-			} else break;
-		} else if(is_white_space(current)) current = get_char(true);
-		else break;
+/// Cuts the file into at most `count` chunks, returning how many it made.
+static size_t split_chunks(string_t content, chunk_t *chunks, size_t count) {
+	// The terminator is counted in the size of the contents
+	size_t size = content.size - 1, made = 0, start = 0;
+	for(size_t i=1; i<=count && start < size; i++) {
+		size_t end = SIZE_MAX, from = size * i / count;
+		if(from < start) from = start;
+		if(i < count) {
+			const char *newline = memchr(&content.string[from], '\n', size - from);
+			if(newline != NULL) end = newline + 1 - content.string;
+		}
+		// Reaching the end of the file makes this the last chunk
+		if(end >= size) end = SIZE_MAX;
+		chunks[made++] = (chunk_t) {
+			.begin = content.string, .start = start, .end = end,
+			.invalid = offset_list_new(NULL, 8)
+		};
+		start = end;
 	}
+	return made;
+}
 
-	// Handle symbols and symbol sequences
-	switch(current) {
-		case '(': RET(TOK_OPEN_ROUND, 1);
-		case ')': RET(TOK_CLOSE_ROUND, 1);
-		case ',': RET(TOK_COMMA, 1);
-		case ':': RET(TOK_COLON, 1);
-		case ';': RET(TOK_SEMICOLON, 1);
-		case '=': {
-			if(get_char(false) == '=') {
-				get_char(true);
-				RET(TOK_OP_COMPARE, 2);
-			} else RET(TOK_OP_ASSIGN, 1);
-		}
-		case '+': {
-			if(get_char(false) == '=') {
-				get_char(true);
-				RET(TOK_OP_ASSIGN_ALT, 2);
-			} else RET(TOK_OP_PLUS, 1);
-		}
-		case '-': {
-			if(get_char(false) == '=') {
-				get_char(true);
-				RET(TOK_OP_ASSIGN_ALT, 2);
-			} else RET(TOK_OP_MINUS, 1);
-		}
-		case '*': {
-			if(get_char(false) == '=') {
-				get_char(true);
-				RET(TOK_OP_ASSIGN_ALT, 2);
-			} else RET(TOK_OP_MULT, 1);
-		}
-		case '/': {
-			if(get_char(false) == '=') {
-				get_char(true);
-				RET(TOK_OP_ASSIGN_ALT, 2);
-			} else RET(TOK_OP_DIV, 1);
-		}
-		case '%': {
-			if(get_char(false) == '=') {
-				get_char(true);
-				RET(TOK_OP_ASSIGN_ALT, 2);
-			} else RET(TOK_OP_MOD, 1);
-		}
-		case '>': {
-			if(get_char(false) == '=') {
-				get_char(true);
-				RET(TOK_OP_COMPARE, 2);
-			} else RET(TOK_OP_COMPARE, 1);
-		}
-		case '<': {
-			char lookahead = get_char(false);
-			if(lookahead == '=') {
-				get_char(true);
-				RET(TOK_OP_COMPARE, 2);
-			} else if(lookahead == '>') {
-				get_char(true);
-				RET(TOK_OP_COMPARE, 2);
-			} else RET(TOK_OP_COMPARE, 1);
-		}
+static void tokenize(lexer_t *lexer, size_t threads) {
+	string_t content = lexer->file.content;
+	size_t count = content.size / CHUNK_MIN_SIZE;
+	if(count > threads) count = threads;
+	if(count < 1) count = 1;
+
+	chunk_t *chunks = (chunk_t *) malloc(count * sizeof(chunk_t));
+	pthread_t *workers = (pthread_t *) malloc(count * sizeof(pthread_t));
+	error_if(chunks == NULL || workers == NULL);
+	if(content.size == 1) {
+		// An empty file still needs its EOF token
+		count = 1, chunks[0] = (chunk_t) {
+			.begin = content.string, .start = 0, .end = SIZE_MAX,
+			.invalid = offset_list_new(NULL, 8)
+		};
+	} else count = split_chunks(content, chunks, count);
+
+	// The first chunk is lexed right here while the others are on threads
+	for(size_t i=1; i<count; i++)
+		error_if(pthread_create(&workers[i], NULL, lex_chunk_thread, &chunks[i]) != 0);
+	lex_chunk(&chunks[0]);
+	memory_stats_t none = {0};
+	for(size_t i=1; i<count; i++) {
+		error_if(pthread_join(workers[i], NULL) != 0);
+		memory_stats_accumulate(memory_stats_local(), &none, &chunks[i].memory);
 	}
 
-	if(isdigit(current)) {
-		// Handle integer literals
-		size_t count = 1;
-		while(true) {
-			char lookahead = get_char(false);
-			if(!is_ident_part(lookahead)) break;
-			current = get_char(true);
-			count++;
+	// A chunk guessed right if it found the same first token as the chunk
+	// before it did past its end, otherwise it started inside a comment and
+	// is lexed again from where the previous chunk stopped
+	size_t total = chunks[0].tokens.count;
+	for(size_t i=1; i<count; i++) {
+		size_t resume = chunks[i - 1].resume;
+		if(chunks[i].first != resume) {
+			chunk_free_tokens(&chunks[i]);
+			chunks[i].start = resume;
+			chunks[i].invalid.count = 0;
+			lex_chunk(&chunks[i]);
 		}
-		RET(TOK_LIT_NUM, count);
-	} else if(isalpha(current) || current == '_') {
-		// Handle identifiers and keywords
-		uint8_t hash = 0;
-		size_t count = 1;
-		while(true) {
-			hash = map_sbox[hash ^ current];
-			char lookahead = get_char(false);
-			if(!is_ident_part(lookahead)) break;
-			current = get_char(true);
-			count++;
+		total += chunks[i].tokens.count;
+	}
+
+	// Stitch the chunks together in order, interning the identifiers
+	// serially so that symbols are assigned in order of first appearance
+	token_buffer_t *tokens = &lexer->tokens;
+	if(count == 1) *tokens = chunks[0].tokens;
+	else {
+		tokens->capacity = total;
+		tokens->types = (uint8_t *) malloc(total * sizeof(uint8_t));
+		tokens->starts = (uint32_t *) malloc(total * sizeof(uint32_t));
+		tokens->lengths = (uint32_t *) malloc(total * sizeof(uint32_t));
+		error_if(!tokens->types || !tokens->starts || !tokens->lengths);
+		for(size_t i=0; i<count; i++) {
+			token_buffer_t *part = &chunks[i].tokens;
+			// Chunks entirely inside a comment have nothing to copy
+			if(part->count == 0) continue;
+			memcpy(&tokens->types[tokens->count], part->types, part->count * sizeof(uint8_t));
+			memcpy(&tokens->starts[tokens->count], part->starts, part->count * sizeof(uint32_t));
+			memcpy(&tokens->lengths[tokens->count], part->lengths, part->count * sizeof(uint32_t));
+			tokens->count += part->count;
+			chunk_free_tokens(&chunks[i]);
 		}
-		hash &= MAP_SIZE - 1;
-		const char *content = &ls.file.content.string[ls.file_ptr - count];
-		const char *keyword = map_keys[hash];
-		if(strncmp(content, keyword, count)) RET(TOK_IDENT, count);
-		else RET(map_vals[hash], count);
-	} else if(current != '\0') {
-		string_t error_spot = CONSTRUCT_STR(1, &ls.file.content.string[ls.file_ptr - 1]);
-		error_t error_descriptor = err_new(ls.file, error_spot, LITERAL_STR("Invalid symbol"));
-		err_submit(error_descriptor, false);
-		return read_token();
-	} else RET(TOK_EOF, 1);
+	}
+	tokens->symbols = (symbol_t *) malloc(tokens->capacity * sizeof(symbol_t));
+	error_if(tokens->symbols == NULL);
+	for(size_t i=0; i<tokens->count; i++) {
+		tokens->symbols[i] = NO_SYMBOL;
+		if(tokens->types[i] != TOK_IDENT) continue;
+		string_t name = CONSTRUCT_STR(tokens->lengths[i], &content.string[tokens->starts[i]]);
+		tokens->symbols[i] = intern_get(&lexer->symbols, name);
+	}
+
+	// Characters skipped while finding the first token are found by the
+	// chunk before too, which went past its end to find the same token
+	if(count == 1) lexer->invalid = chunks[0].invalid;
+	else for(size_t i=0; i<count; i++) {
+		size_t from = i == 0 ? 0 : chunks[i - 1].resume;
+		for(size_t j=0; j<chunks[i].invalid.count; j++)
+			if(chunks[i].invalid.data[j] >= from) offset_list_push(&lexer->invalid, chunks[i].invalid.data[j]);
+		offset_list_free(&chunks[i].invalid);
+	}
+	free(workers);
+	free(chunks);
 }
-#undef RET
 
-static token_list_t *new_allocated_token(void) {
-	token_list_t *ret = (token_list_t *) arena_alloc(&ls.list, sizeof(token_list_t));
-	ret->token = read_token(), ret->next = NULL;
-	return ret;
+/// Returns the index of the first token past an offset, found by bisection.
+static size_t token_after(const lexer_t *lexer, uint32_t offset) {
+	// The EOF token comes after every character of the file
+	size_t low = 0, high = lexer->tokens.count - 1;
+	while(low < high) {
+		size_t middle = low + (high - low) / 2;
+		if(lexer->tokens.starts[middle] > offset) high = middle;
+		else low = middle + 1;
+	}
+	return low;
+}
+
+/// Reports the invalid characters before the given offset.
+static void report_invalid(lexer_t *lexer, size_t end) {
+	while(lexer->reported < lexer->invalid.count && lexer->invalid.data[lexer->reported] < end) {
+		// Counted beforehand as reaching the limit of the errors jumps away
+		uint32_t offset = lexer->invalid.data[lexer->reported++];
+		lexer->report_at = SIZE_MAX;
+		string_t error_spot = CONSTRUCT_STR(1, &lexer->file.content.string[offset]);
+		error_t error_descriptor = err_new(lexer->file, error_spot, LITERAL_STR("Invalid symbol"));
+		err_submit(lexer->errors, error_descriptor, false);
+	}
+	if(lexer->reported < lexer->invalid.count)
+		lexer->report_at = token_after(lexer, lexer->invalid.data[lexer->reported]);
 }
 
 // External Functions //
 
-void lexer_init(string_file_t file) {
-	if(ls.reinit) cleanup();
-	else atexit(cleanup), ls.reinit = true;
+void lexer_init(lexer_t *lexer, string_file_t file, error_sink_t *errors, size_t threads) {
+	// The token offsets and lengths are stored as 32-bit integers
+	if(file.content.size > UINT32_MAX) {
+		errno = EFBIG;
+		error_if(true);
+	}
+
+	lexer->file = file;
+	lexer->tokens = (token_buffer_t) {0};
+	lexer->symbols = intern_new();
+	lexer->next = 0;
+	lexer->errors = errors;
+	lexer->invalid = offset_list_new(NULL, 0);
+	lexer->reported = 0;
+	lexer->report_at = SIZE_MAX;
+	tokenize(lexer, threads);
+	report_invalid(lexer, lexer->tokens.starts[0]);
+}
+
+void lexer_free(lexer_t *lexer) {
+	free(lexer->tokens.types);
+	free(lexer->tokens.starts);
+	free(lexer->tokens.lengths);
+	free(lexer->tokens.symbols);
+	lexer->tokens = (token_buffer_t) {0};
+	intern_free(&lexer->symbols);
+	offset_list_free(&lexer->invalid);
+}
 
-	ls.file = file;
-	ls.file_ptr = 0;
-	ls.list = arena_new(64 * sizeof(token_list_t));
-	ls.last_ptr = new_allocated_token();
-	ls.next_ptr = ls.last_ptr;
+size_t lexer_tell(const lexer_t *lexer) {
+	return lexer->next;
 }
 
-void lexer_backtrack(token_t *next_ptr) {
-	uintptr_t struct_addr = (uintptr_t) next_ptr - offsetof(token_list_t, token);
-	ls.next_ptr = (token_list_t *) struct_addr;
+void lexer_backtrack(lexer_t *lexer, size_t index) {
+	assert(index < lexer->tokens.count);
+	lexer->next = index;
 }
 
-token_t *lexer_next(void) {
-	token_list_t *ret;
-	if(ls.next_ptr == ls.last_ptr) {
-		ret = ls.last_ptr;
-		ls.last_ptr = new_allocated_token();
-		ret->next = ls.next_ptr = ls.last_ptr;
-	} else {
-		ret = ls.next_ptr;
-		ls.next_ptr = ls.next_ptr->next;
+token_t lexer_next(lexer_t *lexer) {
+	token_t ret = lexer_get(lexer, lexer->next);
+	// The last token is always EOF, it is returned again once reached
+	if(lexer->next + 1 < lexer->tokens.count) {
+		lexer->next++;
+		if(lexer->next == lexer->report_at) report_invalid(lexer, lexer->tokens.starts[lexer->next]);
 	}
-	return &ret->token;
+	return ret;
+}
+
+void lexer_report_invalid(lexer_t *lexer) {
+	report_invalid(lexer, SIZE_MAX);
+}
+
+token_type_t lexer_peek(const lexer_t *lexer) {
+	return (token_type_t) lexer->tokens.types[lexer->next];
+}
+
+token_t lexer_get(const lexer_t *lexer, size_t index) {
+	assert(index < lexer->tokens.count);
+	char *start = &lexer->file.content.string[lexer->tokens.starts[index]];
+	return (token_t) {
+		.type = (token_type_t) lexer->tokens.types[index],
+		.index = (uint32_t) index,
+		.symbol = lexer->tokens.symbols[index],
+		.content = CONSTRUCT_STR(lexer->tokens.lengths[index], start)
+	};
+}
+
+const token_buffer_t *lexer_get_tokens(const lexer_t *lexer) {
+	return &lexer->tokens;
 }
 
-token_t *lexer_peek(void) {
-	return &ls.last_ptr->token;
+intern_t *lexer_get_symbols(lexer_t *lexer) {
+	return &lexer->symbols;
 }
 
-string_t lexer_get_src(void) {
-	return ls.file.content;
+string_t lexer_get_src(const lexer_t *lexer) {
+	return lexer->file.content;
 }
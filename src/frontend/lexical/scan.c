@@ -0,0 +1,179 @@
+#include "scan.h"
+#include "charclass.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define SCAN_X86
+#include <immintrin.h>
+#endif
+
+typedef const char *(*scan_fn_t)(const char *);
+
+static struct scan_impl {
+	scan_fn_t space;
+	scan_fn_t ident;
+	scan_fn_t line_end;
+	scan_fn_t comment_end;
+} impl;
+
+// Internal Functions (Scalar) //
+
+static const char *scalar_space(const char *str) {
+	while(char_is(*str, CHAR_WHITE_SPACE)) str++;
+	return str;
+}
+
+static const char *scalar_ident(const char *str) {
+	while(char_is(*str, CHAR_IDENT_PART)) str++;
+	return str;
+}
+
+static const char *scalar_line_end(const char *str) {
+	while(*str != '\n' && *str != '\0') str++;
+	return str;
+}
+
+static const char *scalar_comment_end(const char *str) {
+	while(*str != '\0' && !(str[0] == '*' && str[1] == '/')) str++;
+	return str;
+}
+
+#ifdef SCAN_X86
+
+// Internal Functions (SSE2) //
+
+#define SSE2_SET(c) _mm_set1_epi8((char) (c))
+#define SSE2_EQ(v, c) _mm_cmpeq_epi8(v, SSE2_SET(c))
+#define SSE2_LOAD(str) _mm_loadu_si128((const __m128i *) (str))
+#define SSE2_MASK(v) ((unsigned) _mm_movemask_epi8(v))
+
+static const char *sse2_space(const char *str) {
+	for(;; str += 16) {
+		__m128i v = SSE2_LOAD(str);
+		__m128i white = _mm_or_si128(
+			_mm_or_si128(SSE2_EQ(v, ' '), SSE2_EQ(v, '\t')),
+			_mm_or_si128(SSE2_EQ(v, '\r'), SSE2_EQ(v, '\n'))
+		);
+		unsigned mask = ~SSE2_MASK(white) & 0xFFFF;
+		if(mask != 0) return str + __builtin_ctz(mask);
+	}
+}
+
+static const char *sse2_ident(const char *str) {
+	for(;; str += 16) {
+		__m128i v = SSE2_LOAD(str);
+		// biasing by 128 turns the unsigned range checks into signed ones
+		__m128i lower = _mm_or_si128(v, SSE2_SET(0x20));
+		__m128i alpha = _mm_cmplt_epi8(_mm_add_epi8(lower, SSE2_SET(128 - 'a')), SSE2_SET(-128 + 26));
+		__m128i digit = _mm_cmplt_epi8(_mm_add_epi8(v, SSE2_SET(128 - '0')), SSE2_SET(-128 + 10));
+		__m128i part = _mm_or_si128(_mm_or_si128(alpha, digit), SSE2_EQ(v, '_'));
+		unsigned mask = ~SSE2_MASK(part) & 0xFFFF;
+		if(mask != 0) return str + __builtin_ctz(mask);
+	}
+}
+
+static const char *sse2_line_end(const char *str) {
+	for(;; str += 16) {
+		__m128i v = SSE2_LOAD(str);
+		unsigned mask = SSE2_MASK(_mm_or_si128(SSE2_EQ(v, '\n'), SSE2_EQ(v, '\0')));
+		if(mask != 0) return str + __builtin_ctz(mask);
+	}
+}
+
+static const char *sse2_comment_end(const char *str) {
+	for(;; str += 16) {
+		__m128i v = SSE2_LOAD(str), next = SSE2_LOAD(str + 1);
+		__m128i close = _mm_and_si128(SSE2_EQ(v, '*'), SSE2_EQ(next, '/'));
+		unsigned mask = SSE2_MASK(_mm_or_si128(close, SSE2_EQ(v, '\0')));
+		if(mask != 0) return str + __builtin_ctz(mask);
+	}
+}
+
+// Internal Functions (AVX2) //
+
+#define AVX2_SET(c) _mm256_set1_epi8((char) (c))
+#define AVX2_EQ(v, c) _mm256_cmpeq_epi8(v, AVX2_SET(c))
+#define AVX2_LOAD(str) _mm256_loadu_si256((const __m256i *) (str))
+#define AVX2_MASK(v) ((unsigned) _mm256_movemask_epi8(v))
+
+__attribute__((target("avx2")))
+static const char *avx2_space(const char *str) {
+	for(;; str += 32) {
+		__m256i v = AVX2_LOAD(str);
+		__m256i white = _mm256_or_si256(
+			_mm256_or_si256(AVX2_EQ(v, ' '), AVX2_EQ(v, '\t')),
+			_mm256_or_si256(AVX2_EQ(v, '\r'), AVX2_EQ(v, '\n'))
+		);
+		unsigned mask = ~AVX2_MASK(white);
+		if(mask != 0) return str + __builtin_ctz(mask);
+	}
+}
+
+__attribute__((target("avx2")))
+static const char *avx2_ident(const char *str) {
+	for(;; str += 32) {
+		__m256i v = AVX2_LOAD(str);
+		// there is no unsigned byte comparison, same trick as with SSE2
+		__m256i lower = _mm256_or_si256(v, AVX2_SET(0x20));
+		__m256i alpha = _mm256_cmpgt_epi8(AVX2_SET(-128 + 26), _mm256_add_epi8(lower, AVX2_SET(128 - 'a')));
+		__m256i digit = _mm256_cmpgt_epi8(AVX2_SET(-128 + 10), _mm256_add_epi8(v, AVX2_SET(128 - '0')));
+		__m256i part = _mm256_or_si256(_mm256_or_si256(alpha, digit), AVX2_EQ(v, '_'));
+		unsigned mask = ~AVX2_MASK(part);
+		if(mask != 0) return str + __builtin_ctz(mask);
+	}
+}
+
+__attribute__((target("avx2")))
+static const char *avx2_line_end(const char *str) {
+	for(;; str += 32) {
+		__m256i v = AVX2_LOAD(str);
+		unsigned mask = AVX2_MASK(_mm256_or_si256(AVX2_EQ(v, '\n'), AVX2_EQ(v, '\0')));
+		if(mask != 0) return str + __builtin_ctz(mask);
+	}
+}
+
+__attribute__((target("avx2")))
+static const char *avx2_comment_end(const char *str) {
+	for(;; str += 32) {
+		__m256i v = AVX2_LOAD(str), next = AVX2_LOAD(str + 1);
+		__m256i close = _mm256_and_si256(AVX2_EQ(v, '*'), AVX2_EQ(next, '/'));
+		unsigned mask = AVX2_MASK(_mm256_or_si256(close, AVX2_EQ(v, '\0')));
+		if(mask != 0) return str + __builtin_ctz(mask);
+	}
+}
+
+#endif // SCAN_X86
+
+// External Functions //
+
+void scan_init(void) {
+	impl = (struct scan_impl) {
+		scalar_space, scalar_ident,
+		scalar_line_end, scalar_comment_end
+	};
+#ifdef SCAN_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")) impl = (struct scan_impl) {
+		avx2_space, avx2_ident,
+		avx2_line_end, avx2_comment_end
+	}; else impl = (struct scan_impl) {
+		sse2_space, sse2_ident,
+		sse2_line_end, sse2_comment_end
+	};
+#endif
+}
+
+const char *scan_space(const char *str) {
+	return impl.space(str);
+}
+
+const char *scan_ident(const char *str) {
+	return impl.ident(str);
+}
+
+const char *scan_line_end(const char *str) {
+	return impl.line_end(str);
+}
+
+const char *scan_comment_end(const char *str) {
+	return impl.comment_end(str);
+}
@@ -0,0 +1,342 @@
+#include "fold.h"
+
+#include "frontend/error.h"
+#include "frontend/lexical/lexer.h"
+#include "frontend/semantic/types.h"
+#include "frontend/syntactic/visitor.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct fold_state {
+	string_file_t file;
+	error_sink_t *errors;
+	ast_t *ast;
+	/// Whether each variable is assigned to anywhere after its declaration.
+	bool *assigned;
+} fold_state_t;
+
+// Internal Functions (Helpers) //
+
+static fold_state_t *state(const ast_visit_t *visit) {
+	return (fold_state_t *) visit->context;
+}
+
+static void report(fold_state_t *fs, ast_ref_t node, string_t message) {
+	// Not worth locating, it would be dropped
+	if(err_full(fs->errors)) return;
+	error_t error_descriptor = err_new(fs->file, ast_node_content(fs->ast, node), message);
+	err_submit(fs->errors, error_descriptor, false);
+}
+
+static void overflow(fold_state_t *fs, ast_ref_t node, type_id_t type) {
+	report(fs, node, type == TYPE_NAT ?
+		LITERAL_STR("Constant expression overflows nat") :
+		LITERAL_STR("Constant expression overflows int"));
+}
+
+static bool is_number(type_id_t type) {
+	return type == TYPE_NAT || type == TYPE_INT;
+}
+
+static bool known(fold_state_t *fs, ast_ref_t node) {
+	return fs->ast->folded[node];
+}
+
+static void set(fold_state_t *fs, ast_ref_t node, uint64_t value) {
+	fs->ast->folded[node] = true;
+	fs->ast->values[node] = value;
+}
+
+/** Checks that a known value fits in the type it is used as, which only
+  * fails for a `nat` beyond the largest `int` used as an `int`, and reports
+  * it if not. Such a value would be read as a negative number otherwise.
+  */
+static bool convert(fold_state_t *fs, ast_ref_t node, type_id_t type) {
+	if(type != TYPE_INT || fs->ast->types[node] != TYPE_NAT) return true;
+	if(fs->ast->values[node] <= INT64_MAX) return true;
+	report(fs, node, LITERAL_STR("Constant does not fit in int"));
+	return false;
+}
+
+/// Reads the 64 bits of a value as an `int`, without relying on the cast.
+static int64_t as_int(uint64_t value) {
+	if(value <= INT64_MAX) return (int64_t) value;
+	return -(int64_t) (~value) - 1;
+}
+
+static token_type_t token_type(fold_state_t *fs, ast_ref_t node) {
+	return (token_type_t) fs->ast->tokens->types[ast_get(fs->ast, node)->token];
+}
+
+// Internal Functions (Arithmetic) //
+
+/** Does arithmetic on two `nat`s the way the program would.
+  * @return Whether the result fits, it wraps around if not.
+  */
+static bool nat_arithmetic(token_type_t operator, uint64_t a, uint64_t b, uint64_t *result) {
+	switch(operator) {
+		case TOK_OP_PLUS: *result = a + b; return *result >= a;
+		case TOK_OP_MINUS: *result = a - b; return b <= a;
+		case TOK_OP_MULT: *result = a * b; return a == 0 || *result / a == b;
+		case TOK_OP_DIV: *result = a / b; return true;
+		default: *result = a % b; return true;
+	}
+}
+
+/** Does arithmetic on two `int`s the way the program would, in two's
+  * complement. Operands and result are kept as their 64 bits.
+  * @return Whether the result fits, it wraps around if not.
+  */
+static bool int_arithmetic(token_type_t operator, uint64_t a, uint64_t b, uint64_t *result) {
+	int64_t x = as_int(a), y = as_int(b);
+	switch(operator) {
+		case TOK_OP_PLUS:
+			*result = a + b;
+			return y > 0 ? x <= INT64_MAX - y : x >= INT64_MIN - y;
+		case TOK_OP_MINUS:
+			*result = a - b;
+			return y < 0 ? x <= INT64_MAX + y : x >= INT64_MIN + y;
+		case TOK_OP_MULT:
+			*result = a * b;
+			// The product is exact if it divides back, which -1 can not do
+			if(x == -1) return y != INT64_MIN;
+			return x == 0 || as_int(*result) / x == y;
+		case TOK_OP_DIV:
+			// The quotient of the most negative int by -1 is one too big
+			if(x == INT64_MIN && y == -1) {
+				*result = a;
+				return false;
+			}
+			*result = (uint64_t) (x / y);
+			return true;
+		default:
+			*result = y == -1 ? 0 : (uint64_t) (x % y);
+			return true;
+	}
+}
+
+// Internal Functions (Node Types) //
+
+static void fold_literal(fold_state_t *fs, ast_ref_t ref) {
+	switch(token_type(fs, ref)) {
+		case TOK_KW_TRUE: set(fs, ref, 1); return;
+		case TOK_KW_FALSE:
+		case TOK_KW_NIL: set(fs, ref, 0); return;
+		default: ;
+	}
+
+	string_t content = ast_node_content(fs->ast, ref);
+	uint64_t value = 0;
+	for(size_t i=0; i<content.size; i++) {
+		uint64_t digit = (uint64_t) (content.string[i] - '0');
+		if(value > (UINT64_MAX - digit) / 10) {
+			report(fs, ref, LITERAL_STR("Number does not fit in 64 bits"));
+			return;
+		}
+		value = value * 10 + digit;
+	}
+	set(fs, ref, value);
+}
+
+static void fold_unary(fold_state_t *fs, ast_ref_t ref) {
+	ast_ref_t operand = ast_get(fs->ast, ref)->children.pair.right;
+	if(!known(fs, operand)) return;
+	type_id_t type = fs->ast->types[operand];
+	uint64_t value = fs->ast->values[operand];
+	switch(token_type(fs, ref)) {
+		case TOK_KW_NOT:
+			if(type == TYPE_BOOL) set(fs, ref, !value);
+			return;
+		case TOK_OP_MINUS:
+			if(!is_number(type)) return;
+			// Negating gives an int, which reaches one further down than up
+			if(type == TYPE_NAT ? value > (uint64_t) INT64_MAX + 1 : value == (uint64_t) INT64_MAX + 1)
+				overflow(fs, ref, TYPE_INT);
+			else set(fs, ref, 0 - value);
+			return;
+		default:
+			if(is_number(type)) set(fs, ref, value);
+	}
+}
+
+/// Folds `and` and `or`, which only need their left side if it decides.
+static void fold_logic(fold_state_t *fs, ast_ref_t ref, bool is_and) {
+	ast_node_t *node = ast_get(fs->ast, ref);
+	ast_ref_t left = node->children.pair.left, right = node->children.pair.right;
+	if(fs->ast->types[left] != TYPE_BOOL || !known(fs, left)) return;
+	// The right side is never run if the left decides, so it can be anything
+	if((fs->ast->values[left] != 0) != is_and) set(fs, ref, fs->ast->values[left]);
+	else if(fs->ast->types[right] == TYPE_BOOL && known(fs, right)) set(fs, ref, fs->ast->values[right]);
+}
+
+static void fold_compare(fold_state_t *fs, ast_ref_t ref) {
+	ast_node_t *node = ast_get(fs->ast, ref);
+	ast_ref_t left = node->children.pair.left, right = node->children.pair.right;
+	type_id_t left_type = fs->ast->types[left], right_type = fs->ast->types[right];
+	bool numbers = is_number(left_type) && is_number(right_type);
+	if(left_type != right_type && !numbers) return;
+
+	// A nat is compared with an int as an int
+	type_id_t common = left_type == right_type ? left_type : TYPE_INT;
+	bool left_fits = known(fs, left) && convert(fs, left, common);
+	bool right_fits = known(fs, right) && convert(fs, right, common);
+	if(!left_fits || !right_fits) return;
+	uint64_t a = fs->ast->values[left], b = fs->ast->values[right];
+
+	string_t operator = ast_node_content(fs->ast, ref);
+	bool or_equal = operator.size == 2 && operator.string[1] == '=';
+	if(operator.string[0] == '=') set(fs, ref, a == b);
+	else if(operator.string[0] == '<' && operator.size == 2 && operator.string[1] == '>') set(fs, ref, a != b);
+	else if(numbers) {
+		// Greater is less with the operands the other way around
+		if(operator.string[0] == '>') {
+			uint64_t swap = a;
+			a = b, b = swap;
+		}
+		// Ordering is unsigned only if both sides are nat, as in the program
+		bool less = common == TYPE_NAT ? a < b : as_int(a) < as_int(b);
+		set(fs, ref, less || (or_equal && a == b));
+	}
+}
+
+static void fold_binary(fold_state_t *fs, ast_ref_t ref) {
+	ast_node_t *node = ast_get(fs->ast, ref);
+	ast_ref_t left = node->children.pair.left, right = node->children.pair.right;
+	token_type_t operator = token_type(fs, ref);
+	switch(operator) {
+		case TOK_OP_ASSIGN:
+		case TOK_OP_ASSIGN_ALT:
+			// Never folded, but the value assigned still has to fit
+			if(known(fs, right)) convert(fs, right, fs->ast->types[left]);
+			return;
+		case TOK_OP_COMPARE:
+			fold_compare(fs, ref);
+			return;
+		case TOK_KW_AND:
+		case TOK_KW_OR:
+			fold_logic(fs, ref, operator == TOK_KW_AND);
+			return;
+		default: ;
+	}
+
+	type_id_t type = fs->ast->types[ref];
+	if(!is_number(type)) return;
+	// Either side of int arithmetic may be a nat, used as an int
+	bool left_fits = known(fs, left) && convert(fs, left, type);
+	bool right_fits = known(fs, right) && convert(fs, right, type);
+	if(!left_fits || !right_fits) return;
+	uint64_t a = fs->ast->values[left], b = fs->ast->values[right];
+	if((operator == TOK_OP_DIV || operator == TOK_OP_MOD) && b == 0) {
+		report(fs, ref, LITERAL_STR("Division by zero"));
+		return;
+	}
+	uint64_t result;
+	bool fits = type == TYPE_NAT ?
+		nat_arithmetic(operator, a, b, &result) :
+		int_arithmetic(operator, a, b, &result);
+	if(fits) set(fs, ref, result);
+	else overflow(fs, ref, type);
+}
+
+static void fold_if(fold_state_t *fs, ast_ref_t ref) {
+	size_t count = ast_child_count(fs->ast, ref);
+	// The value of every branch is used as the type of the if
+	bool fits = true;
+	for(size_t i=0; i<count; i++) {
+		ast_ref_t body = ast_get(fs->ast, ast_child(fs->ast, ref, i))->children.pair.right;
+		if(known(fs, body) && !convert(fs, body, fs->ast->types[ref])) fits = false;
+	}
+	if(!fits) return;
+
+	for(size_t i=0; i<count; i++) {
+		ast_node_t *single = ast_get(fs->ast, ast_child(fs->ast, ref, i));
+		ast_ref_t condition = single->children.pair.left, body = single->children.pair.right;
+		// The else branch has no condition and is taken if nothing else is
+		if(condition != AST_NONE) {
+			if(!known(fs, condition)) return;
+			if(fs->ast->values[condition] == 0) continue;
+		}
+		if(known(fs, body)) set(fs, ref, fs->ast->values[body]);
+		return;
+	}
+	// No branch is taken, which leaves nil
+	set(fs, ref, 0);
+}
+
+static void fold_block(fold_state_t *fs, ast_ref_t ref) {
+	size_t count = ast_child_count(fs->ast, ref);
+	for(size_t i=0; i<count; i++)
+		if(!known(fs, ast_child(fs->ast, ref, i))) return;
+	set(fs, ref, count > 0 ? fs->ast->values[ast_child(fs->ast, ref, count - 1)] : 0);
+}
+
+// Internal Functions (Visitor) //
+
+static void fold(const ast_visit_t *visit) {
+	fold_state_t *fs = state(visit);
+	ast_ref_t ref = visit->node;
+	ast_node_t *node = ast_get(visit->tree, ref);
+	// Whatever did not type has been reported already
+	if(visit->tree->types[ref] == TYPE_UNKNOWN) return;
+	switch(node->type) {
+		case AST_LITERAL:
+			fold_literal(fs, ref);
+			break;
+		case AST_IDENT:
+			if(known(fs, visit->tree->decls[ref]))
+				set(fs, ref, visit->tree->values[visit->tree->decls[ref]]);
+			break;
+		case AST_OP_UNARY:
+			fold_unary(fs, ref);
+			break;
+		case AST_OP_BINARY:
+			fold_binary(fs, ref);
+			break;
+		case AST_VAR_SINGLE: ;
+			// A variable is folded into its value if it keeps it for good
+			ast_ref_t value = node->children.pair.right;
+			type_id_t type = visit->tree->types[value];
+			if(!known(fs, value) || !convert(fs, value, visit->tree->types[ref])) break;
+			if(fs->assigned[ref]) break;
+			if(type == visit->tree->types[ref] || (type == TYPE_NAT && visit->tree->types[ref] == TYPE_INT))
+				set(fs, ref, visit->tree->values[value]);
+			break;
+		case AST_IF_LIST:
+			fold_if(fs, ref);
+			break;
+		case AST_BLOCK:
+			fold_block(fs, ref);
+			break;
+		default: ;
+	}
+}
+
+// External Functions //
+
+void fold_run(string_file_t file, ast_t *ast, error_sink_t *errors) {
+	assert(ast->decls != NULL && ast->types != NULL);
+	fold_state_t fs = {.file = file, .errors = errors, .ast = ast};
+	ast->folded = (bool *) ast_side_array(ast, sizeof(bool));
+	ast->values = (uint64_t *) ast_side_array(ast, sizeof(uint64_t));
+	fs.assigned = (bool *) calloc(ast->nodes.count, sizeof(bool));
+	error_if(fs.assigned == NULL);
+
+	// Assignments can come after the uses of a variable, inside of a loop,
+	// so they are all found up front
+	for(ast_ref_t ref = 1; ref < ast->nodes.count; ref++) {
+		ast_node_t *node = ast_get(ast, ref);
+		if(node->type != AST_OP_BINARY) continue;
+		token_type_t operator = token_type(&fs, ref);
+		if(operator != TOK_OP_ASSIGN && operator != TOK_OP_ASSIGN_ALT) continue;
+		if(ast_get(ast, node->children.pair.left)->type == AST_IDENT)
+			fs.assigned[ast->decls[node->children.pair.left]] = true;
+	}
+
+	ast_visitor_t visitor = {.context = &fs};
+	for(size_t i=0; i<AST_NODE_COUNT; i++) visitor.post[i] = fold;
+	ast_walk(ast, ast->root, &visitor);
+	free(fs.assigned);
+}
@@ -1,40 +1,145 @@
 #include "scope.h"
 
+#include "common/arena.h"
+#include "common/vector.h"
+#include "frontend/error.h"
+#include "frontend/syntactic/visitor.h"
+
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/** A variable declaration that is or was visible at some point of the walk.
+  * The bindings of a symbol are chained from the innermost outwards, closed
+  * scopes are only noticed and unlinked from the chain on the next lookup.
+  */
+typedef struct binding {
+	/// The `AST_VAR_SINGLE` node that declared the variable.
+	ast_ref_t decl;
+	/// Index plus one of the binding this one shadows, 0 if none.
+	uint32_t previous;
+	/// The depth of the scope the declaration was made in.
+	uint32_t depth;
+	/// The serial number of the scope the declaration was made in.
+	uint32_t serial;
+} binding_t;
+
+VECTOR_DEFINE(binding_list, binding_t)
+VECTOR_DEFINE(serial_stack, uint32_t)
+
+typedef struct scope_state {
+	string_file_t file;
+	error_sink_t *errors;
+	ast_t *ast;
+	arena_t arena;
+	/// Every binding made so far, in order of declaration.
+	binding_list_t bindings;
+	/// The serial number of each open scope, indexed by depth.
+	serial_stack_t scopes;
+	/// Index plus one of the innermost binding of each symbol, 0 if none.
+	uint32_t *heads;
+	uint32_t next_serial;
+} scope_state_t;
 
-void scope_walker(ast_node_t *current) {
-	if(current == NULL) return;
-	bool flag = false;
-	switch(current->type) {
-		case AST_RETURN:
-		case AST_WHILE:
-		case AST_IF_SINGLE:
-			scope_walker(current->children.pair.left);
-			scope_walker(current->children.pair.right);
-			break;
-		case AST_BLOCK:
-			// special case for block
-			flag = true;
-			printf("->\n");
-			// fall through
-		case AST_CALL:
-		case AST_IF_LIST:
-		case AST_VAR_LIST:
-			for(size_t i=0; i<current->children.list.count; i++)
-				scope_walker(current->children.list.list[i]);
-			break;
-		case AST_VAR_SINGLE:
-			printf("%.*s\n",
-				(int)current->content.size,
-				current->content.string
-			);
-		default: return;
+// Internal Functions //
+
+static void report(scope_state_t *ss, ast_ref_t node, string_t message) {
+	error_t error_descriptor = err_new(ss->file, ast_node_content(ss->ast, node), message);
+	err_submit(ss->errors, error_descriptor, false);
+}
+
+static bool is_open(scope_state_t *ss, binding_t *binding) {
+	if(binding->depth >= ss->scopes.count) return false;
+	return ss->scopes.data[binding->depth] == binding->serial;
+}
+
+static binding_t *lookup(scope_state_t *ss, symbol_t symbol) {
+	uint32_t index = ss->heads[symbol];
+	binding_t *binding = NULL;
+	for(; index != 0; index = binding->previous) {
+		binding = &ss->bindings.data[index - 1];
+		if(is_open(ss, binding)) break;
 	}
-	if(flag) printf("<-\n");
+	// bindings of closed scopes can never become visible again
+	ss->heads[symbol] = index;
+	return index == 0 ? NULL : binding;
+}
+
+static void declare(scope_state_t *ss, ast_ref_t decl) {
+	symbol_t symbol = ast_node_symbol(ss->ast, decl);
+	if(symbol == NO_SYMBOL) return;
+	uint32_t depth = (uint32_t) ss->scopes.count - 1;
+
+	binding_t *visible = lookup(ss, symbol);
+	if(visible != NULL && visible->depth == depth)
+		report(ss, decl, LITERAL_STR("Variable already declared in this scope"));
+	else if(visible != NULL)
+		report(ss, decl, LITERAL_STR("Variable shadows an outer declaration"));
+
+	binding_t binding = {
+		.decl = decl, .previous = ss->heads[symbol],
+		.depth = depth, .serial = *serial_stack_peek(&ss->scopes)
+	};
+	binding_list_push(&ss->bindings, binding);
+	ss->heads[symbol] = (uint32_t) ss->bindings.count;
+}
+
+static void resolve(scope_state_t *ss, ast_ref_t ident) {
+	symbol_t symbol = ast_node_symbol(ss->ast, ident);
+	if(symbol == NO_SYMBOL) return;
+	binding_t *binding = lookup(ss, symbol);
+	if(binding == NULL) report(ss, ident, LITERAL_STR("Undeclared variable"));
+	else ss->ast->decls[ident] = binding->decl;
 }
 
-void scope_run(ast_t *ast) {
-	assert(ast->root->type == AST_BLOCK);
-	scope_walker(ast->root);
+static scope_state_t *state(const ast_visit_t *visit) {
+	return (scope_state_t *) visit->context;
+}
+
+static bool enter_ident(const ast_visit_t *visit) {
+	resolve(state(visit), visit->node);
+	return true;
+}
+
+static void leave_variable(const ast_visit_t *visit) {
+	// the variable is not yet visible in its own initializer
+	declare(state(visit), visit->node);
+}
+
+static bool enter_block(const ast_visit_t *visit) {
+	scope_state_t *ss = state(visit);
+	serial_stack_push(&ss->scopes, ss->next_serial++);
+	return true;
+}
+
+static void leave_block(const ast_visit_t *visit) {
+	// popping is constant time, the bindings are unlinked lazily
+	serial_stack_pop(&state(visit)->scopes);
+}
+
+// External Functions //
+
+void scope_run(string_file_t file, ast_t *ast, size_t symbol_count, error_sink_t *errors) {
+	assert(ast_get(ast, ast->root)->type == AST_BLOCK);
+
+	scope_state_t ss = {.file = file, .errors = errors, .ast = ast, .next_serial = 0};
+	ast->decls = (ast_ref_t *) ast_side_array(ast, sizeof(ast_ref_t));
+	ss.arena = arena_new(4096);
+	ss.bindings = binding_list_new(&ss.arena, 64);
+	ss.scopes = serial_stack_new(&ss.arena, 16);
+	ss.heads = (uint32_t *) calloc(symbol_count + 1, sizeof(uint32_t));
+	error_if(ss.heads == NULL);
+
+	ast_visitor_t visitor = {
+		.pre[AST_IDENT] = enter_ident,
+		.pre[AST_BLOCK] = enter_block,
+		.post[AST_VAR_SINGLE] = leave_variable,
+		.post[AST_BLOCK] = leave_block,
+		.context = &ss
+	};
+	ast_walk(ast, ast->root, &visitor);
+
+	free(ss.heads);
+	arena_free(&ss.arena);
 }
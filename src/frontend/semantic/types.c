@@ -0,0 +1,312 @@
+#include "types.h"
+
+#include "frontend/error.h"
+#include "frontend/lexical/lexer.h"
+#include "frontend/syntactic/visitor.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const char *type_names[] = {
+	FOREACH_TYPE(GENERATE_TYPE_STRS)
+};
+
+typedef struct type_state {
+	string_file_t file;
+	error_sink_t *errors;
+	ast_t *ast;
+	/// Whether the value of each node is used rather than thrown away.
+	bool *used;
+} type_state_t;
+
+// Internal Functions (Helpers) //
+
+static type_state_t *state(const ast_visit_t *visit) {
+	return (type_state_t *) visit->context;
+}
+
+static void report(type_state_t *ts, ast_ref_t node, const char *format, ...) {
+	// Not worth formatting, it would be dropped
+	if(err_full(ts->errors)) return;
+
+	// Nodes without a token of their own are shown by their first child
+	while(ast_get(ts->ast, node)->token == AST_NO_TOKEN) {
+		ast_ref_t child = AST_NONE;
+		for(size_t i=0; child == AST_NONE && i<ast_child_count(ts->ast, node); i++)
+			child = ast_child(ts->ast, node, i);
+		if(child == AST_NONE) break;
+		node = child;
+	}
+
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(NULL, 0, format, args);
+	va_end(args);
+	char *message = arena_alloc(err_get_arena(ts->errors), length + 1);
+	va_start(args, format);
+	vsnprintf(message, length + 1, format, args);
+	va_end(args);
+
+	string_t error_spot = ast_node_content(ts->ast, node);
+	error_t error_descriptor = err_new(ts->file, error_spot, CONSTRUCT_STR(length, message));
+	err_submit(ts->errors, error_descriptor, false);
+}
+
+static bool is_number(type_id_t type) {
+	return type == TYPE_NAT || type == TYPE_INT;
+}
+
+/// Whether a value of one type can be used where the other is expected.
+static bool fits(type_id_t from, type_id_t to) {
+	return from == to || from == TYPE_UNKNOWN || to == TYPE_UNKNOWN
+		|| from == TYPE_NEVER || (from == TYPE_NAT && to == TYPE_INT);
+}
+
+/// The type that values of both types fit in or `TYPE_COUNT` if none.
+static type_id_t join(type_id_t a, type_id_t b) {
+	if(fits(a, b)) return b;
+	if(fits(b, a)) return a;
+	return TYPE_COUNT;
+}
+
+/// The type of arithmetic on two numbers, which is only `nat` if both are.
+static type_id_t arithmetic(type_id_t left, type_id_t right) {
+	if(left == TYPE_UNKNOWN || right == TYPE_UNKNOWN) return TYPE_UNKNOWN;
+	if(left == TYPE_NAT && right == TYPE_NAT) return TYPE_NAT;
+	if(is_number(left) && is_number(right)) return TYPE_INT;
+	return TYPE_UNKNOWN;
+}
+
+static type_id_t type_of(type_state_t *ts, ast_ref_t node) {
+	// The placeholder of `AST_NONE` is never typed and stays unknown
+	return ts->ast->types[node];
+}
+
+static void expect_type(type_state_t *ts, ast_ref_t node, type_id_t expected) {
+	type_id_t type = type_of(ts, node);
+	if(!fits(type, expected))
+		report(ts, node, "Expected %s but found %s", type_names[expected], type_names[type]);
+}
+
+static void expect_number(type_state_t *ts, ast_ref_t node) {
+	type_id_t type = type_of(ts, node);
+	if(!is_number(type) && type != TYPE_UNKNOWN && type != TYPE_NEVER)
+		report(ts, node, "Expected a number but found %s", type_names[type]);
+}
+
+static bool expect_variable(type_state_t *ts, ast_ref_t node) {
+	ast_node_type_t type = ast_get(ts->ast, node)->type;
+	if(type == AST_IDENT) return true;
+	// Missing and erroneous operands were reported by the parser already
+	if(node != AST_NONE && type != AST_ERROR) report(ts, node, "Can only assign to a variable");
+	return false;
+}
+
+static token_type_t token_type(type_state_t *ts, ast_ref_t node) {
+	return (token_type_t) ts->ast->tokens->types[ast_get(ts->ast, node)->token];
+}
+
+// Internal Functions (Node Types) //
+
+static type_id_t type_unary(type_state_t *ts, ast_ref_t node) {
+	ast_ref_t operand = ast_get(ts->ast, node)->children.pair.right;
+	switch(token_type(ts, node)) {
+		case TOK_KW_NOT:
+			expect_type(ts, operand, TYPE_BOOL);
+			return TYPE_BOOL;
+		case TOK_OP_MINUS:
+			expect_number(ts, operand);
+			return TYPE_INT;
+		default:
+			expect_number(ts, operand);
+			return arithmetic(type_of(ts, operand), TYPE_NAT);
+	}
+}
+
+static type_id_t type_binary(type_state_t *ts, ast_ref_t node) {
+	ast_node_t *binary = ast_get(ts->ast, node);
+	ast_ref_t left = binary->children.pair.left, right = binary->children.pair.right;
+	type_id_t left_type = type_of(ts, left), right_type = type_of(ts, right);
+	switch(token_type(ts, node)) {
+		case TOK_OP_ASSIGN:
+			if(!expect_variable(ts, left)) return right_type;
+			expect_type(ts, right, left_type);
+			return left_type;
+		case TOK_OP_ASSIGN_ALT:
+			expect_number(ts, left);
+			expect_number(ts, right);
+			if(!expect_variable(ts, left)) return arithmetic(left_type, right_type);
+			// Adding an int to a nat would not fit back in it
+			if(is_number(left_type)) expect_type(ts, right, left_type);
+			return left_type;
+		case TOK_KW_AND:
+		case TOK_KW_OR:
+			expect_type(ts, left, TYPE_BOOL);
+			expect_type(ts, right, TYPE_BOOL);
+			return TYPE_BOOL;
+		case TOK_OP_COMPARE: ;
+			string_t operator = ast_node_content(ts->ast, node);
+			bool equality = operator.string[0] == '=' || (operator.size == 2 && operator.string[1] == '>');
+			if(!equality) {
+				expect_number(ts, left);
+				expect_number(ts, right);
+			} else if(join(left_type, right_type) == TYPE_COUNT) report(ts, node,
+				"Can not compare %s with %s", type_names[left_type], type_names[right_type]);
+			return TYPE_BOOL;
+		default:
+			expect_number(ts, left);
+			expect_number(ts, right);
+			return arithmetic(left_type, right_type);
+	}
+}
+
+static type_id_t type_if(type_state_t *ts, ast_ref_t node) {
+	if(!ts->used[node]) return TYPE_NIL;
+	size_t count = ast_child_count(ts->ast, node);
+	type_id_t type = TYPE_NEVER;
+	for(size_t i=0; i<count; i++) {
+		type_id_t branch = type_of(ts, ast_child(ts->ast, node, i));
+		type_id_t joined = join(type, branch);
+		if(joined == TYPE_COUNT) {
+			report(ts, node, "Branches of the if have different types, %s and %s",
+				type_names[type], type_names[branch]);
+			return TYPE_UNKNOWN;
+		}
+		type = joined;
+	}
+
+	// Without an else the value is nil when no condition holds
+	ast_ref_t last = ast_child(ts->ast, node, count - 1);
+	if(ast_get(ts->ast, last)->children.pair.left == AST_NONE) return type;
+	if(join(type, TYPE_NIL) != TYPE_COUNT) return join(type, TYPE_NIL);
+	report(ts, node, "Branches of the if have different types, %s and nil without an else",
+		type_names[type]);
+	return TYPE_UNKNOWN;
+}
+
+static type_id_t type_block(type_state_t *ts, ast_ref_t node) {
+	size_t count = ast_child_count(ts->ast, node);
+	// Nothing after a return is ever reached
+	for(size_t i=0; i<count; i++)
+		if(type_of(ts, ast_child(ts->ast, node, i)) == TYPE_NEVER) return TYPE_NEVER;
+	if(count == 0 || !ts->used[node]) return TYPE_NIL;
+	return type_of(ts, ast_child(ts->ast, node, count - 1));
+}
+
+// Internal Functions (Visitor) //
+
+static bool mark_used(const ast_visit_t *visit) {
+	type_state_t *ts = state(visit);
+	ast_node_t *node = ast_get(visit->tree, visit->node);
+	size_t count = ast_child_count(visit->tree, visit->node);
+	bool used = ts->used[visit->node];
+	switch(node->type) {
+		case AST_OP_UNARY:
+		case AST_OP_BINARY:
+		case AST_CALL:
+		case AST_RETURN:
+		case AST_VAR_SINGLE:
+			for(size_t i=0; i<count; i++) ts->used[ast_child(visit->tree, visit->node, i)] = true;
+			break;
+		case AST_WHILE:
+			ts->used[node->children.pair.left] = true;
+			break;
+		case AST_IF_SINGLE:
+			ts->used[node->children.pair.left] = true;
+			ts->used[node->children.pair.right] = used;
+			break;
+		case AST_IF_LIST:
+			for(size_t i=0; i<count; i++) ts->used[ast_child(visit->tree, visit->node, i)] = used;
+			break;
+		case AST_BLOCK:
+			if(count > 0) ts->used[ast_child(visit->tree, visit->node, count - 1)] = used;
+			break;
+		default: ;
+	}
+	return true;
+}
+
+static void infer(const ast_visit_t *visit) {
+	type_state_t *ts = state(visit);
+	ast_ref_t ref = visit->node;
+	ast_node_t *node = ast_get(visit->tree, ref);
+	type_id_t type = TYPE_UNKNOWN;
+	switch(node->type) {
+		case AST_LITERAL:
+			switch(token_type(ts, ref)) {
+				case TOK_LIT_NUM: type = TYPE_NAT; break;
+				case TOK_KW_NIL: type = TYPE_NIL; break;
+				default: type = TYPE_BOOL;
+			}
+			break;
+		case AST_TYPE:
+			switch(token_type(ts, ref)) {
+				case TOK_TYPE_NAT: type = TYPE_NAT; break;
+				case TOK_TYPE_INT: type = TYPE_INT; break;
+				default: type = TYPE_BOOL;
+			}
+			break;
+		case AST_IDENT:
+			type = type_of(ts, visit->tree->decls[ref]);
+			break;
+		case AST_OP_UNARY:
+			type = type_unary(ts, ref);
+			break;
+		case AST_OP_BINARY:
+			type = type_binary(ts, ref);
+			break;
+		case AST_VAR_SINGLE:
+			if(node->children.pair.left != AST_NONE) {
+				type = type_of(ts, node->children.pair.left);
+				expect_type(ts, node->children.pair.right, type);
+			} else type = type_of(ts, node->children.pair.right);
+			// A variable that is never given a value is of no use to type
+			if(type == TYPE_NEVER) type = TYPE_UNKNOWN;
+			break;
+		case AST_RETURN:
+			type = TYPE_NEVER;
+			break;
+		case AST_WHILE:
+			expect_type(ts, node->children.pair.left, TYPE_BOOL);
+			type = TYPE_NIL;
+			break;
+		case AST_IF_SINGLE:
+			if(node->children.pair.left != AST_NONE)
+				expect_type(ts, node->children.pair.left, TYPE_BOOL);
+			type = type_of(ts, node->children.pair.right);
+			break;
+		case AST_IF_LIST:
+			type = type_if(ts, ref);
+			break;
+		case AST_BLOCK:
+			type = type_block(ts, ref);
+			break;
+		case AST_VAR_LIST:
+			type = TYPE_NIL;
+			break;
+		// The functions that are called are not declared anywhere yet
+		default: ;
+	}
+	visit->tree->types[ref] = type;
+}
+
+// External Functions //
+
+void types_run(string_file_t file, ast_t *ast, error_sink_t *errors) {
+	assert(ast->decls != NULL);
+	type_state_t ts = {.file = file, .errors = errors, .ast = ast};
+	ast->types = (uint8_t *) ast_side_array(ast, sizeof(type_id_t));
+	ts.used = (bool *) calloc(ast->nodes.count, sizeof(bool));
+	error_if(ts.used == NULL);
+
+	ast_visitor_t visitor = {.context = &ts};
+	for(size_t i=0; i<AST_NODE_COUNT; i++) {
+		visitor.pre[i] = mark_used;
+		visitor.post[i] = infer;
+	}
+	ast_walk(ast, ast->root, &visitor);
+	free(ts.used);
+}
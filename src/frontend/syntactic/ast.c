@@ -7,113 +7,82 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define BOX_CHAR_SIZE 4
-static void visualizer_walker(ast_node_t *root, size_t depth, string_t *prefix, bool last) {
-	for(size_t i=0; i<depth; i+=4) printf("\x1b[0;32m%.*s ", BOX_CHAR_SIZE, &prefix->string[i]);
-	if(depth > 0) {
-		char *parent_prefix = &prefix->string[depth - BOX_CHAR_SIZE];
-		// Note: This whitespace-looking character is actually U+2800
-		// also known as Braille Pattern Blank. Can't use a normal space
-		// because all of the prefix characters have to be the same size.
-		memcpy(parent_prefix, last ? "⠀" : "│", BOX_CHAR_SIZE);
-	}
+// Internal Functions //
 
-	printf(
-		"\x1b[33m%-12s %.*s\n",
-		node_type_strs[root->type],
-		(int) root->content.size,
-		root->content.string
-	);
-
-	if(depth >= prefix->size) {
-		char *new_buffer = (char *) realloc(prefix->string, prefix->size * 2);
-		error_if(new_buffer == NULL);
-		prefix->size *= 2, prefix->string = new_buffer;
-	}
-
-	if(root->type < AST_FIRST_LIST_NODE) {
-		if(root->children.pair.left != NULL) {
-			bool is_last = (root->children.pair.right == NULL);
-			char *extra_prefix = (is_last ? "└" : "├");
-			memcpy(&prefix->string[depth], extra_prefix, BOX_CHAR_SIZE);
-			visualizer_walker(root->children.pair.left, depth + BOX_CHAR_SIZE, prefix, is_last);
-		}
-		if(root->children.pair.right != NULL) {
-			memcpy(&prefix->string[depth], "└", BOX_CHAR_SIZE);
-			visualizer_walker(root->children.pair.right, depth + BOX_CHAR_SIZE, prefix, true);
-		}
-	} else {
-		size_t child_count = root->children.list.count;
-		for(size_t i=0; i<child_count; i++) {
-			bool is_last = (i == child_count - 1);
-			char *extra_prefix = (is_last ? "└" : "├");
-			memcpy(&prefix->string[depth], extra_prefix, BOX_CHAR_SIZE);
-
-			ast_node_t *child = root->children.list.list[i];
-			if(child == NULL) continue;
-			visualizer_walker(child, depth + BOX_CHAR_SIZE, prefix, is_last);
-		}
-	}
+static ast_ref_t add_node(ast_t *tree, ast_node_t node) {
+	// References are 32-bit, a tree can never get that big from a file
+	// whose size fits in 32 bits but better safe than sorry
+	assert(tree->nodes.count < UINT32_MAX);
+	ast_node_list_push(&tree->nodes, node);
+	return (ast_ref_t) (tree->nodes.count - 1);
 }
 
 // External Functions //
 
-ast_node_t *ast_pnode_new(ast_t *tree, ast_node_type_t type, string_t content) {
+ast_ref_t ast_pnode_new(ast_t *tree, ast_node_type_t type, uint32_t token) {
 	assert(type < AST_FIRST_LIST_NODE);
-	ast_node_t *node = (ast_node_t *) arena_alloc(&tree->arena, sizeof(ast_node_t));
-	error_if(node == NULL);
-	node->type = type, node->content = content;
-	node->children.pair.left = node->children.pair.right = NULL; // redundant
-	return node;
+	return add_node(tree, (ast_node_t) {
+		.type = type, .token = token,
+		.children.pair = {.left = AST_NONE, .right = AST_NONE}
+	});
 }
 
-ast_node_t *ast_lnode_new(ast_t *tree, size_t capacity, ast_node_type_t type, string_t content) {
+ast_ref_t ast_lnode_new(ast_t *tree, ast_node_type_t type, uint32_t token) {
 	assert(type >= AST_FIRST_LIST_NODE);
-	size_t list_size_bytes = capacity * sizeof(ast_node_t *);
-	ast_node_t *node = (ast_node_t *) arena_alloc(
-		&tree->arena, sizeof(ast_node_t) + list_size_bytes);
-	error_if(node == NULL);
-	node->type = type, node->content = content;
-	node->children.list.capacity = capacity;
-	node->children.list.count = 0; // redundant
-	memset(node->children.list.list, 0, list_size_bytes); // redundant
-	return node;
+	return add_node(tree, (ast_node_t) {
+		.type = type, .token = token,
+		.children.list = {.first = 0, .count = 0}
+	});
 }
 
-ast_node_t *ast_lnode_add(ast_t *tree, ast_node_t *parent, ast_node_t *child) {
-	if(parent->children.list.count == parent->children.list.capacity) {
-		ast_node_t *resized = ast_lnode_new(
-			tree, parent->children.list.capacity * 2,
-			parent->type, parent->content
-		);
-		resized->children.list.count = parent->children.list.count;
-		for(size_t i=0; i<parent->children.list.count; i++)
-			resized->children.list.list[i] = parent->children.list.list[i];
-		parent = resized;
-	}
+void ast_lnode_set(ast_t *tree, ast_ref_t parent, const ast_ref_t *children, size_t count) {
+	assert(ast_get(tree, parent)->type >= AST_FIRST_LIST_NODE);
+	uint32_t first = (uint32_t) tree->lists.count;
+	for(size_t i=0; i<count; i++) ast_ref_list_push(&tree->lists, children[i]);
+	ast_node_t *node = ast_get(tree, parent);
+	node->children.list.first = first;
+	node->children.list.count = (uint32_t) count;
+}
 
-	size_t child_idx = parent->children.list.count;
-	parent->children.list.list[child_idx] = child;
-	parent->children.list.count++;
-	return parent;
+string_t ast_node_content(const ast_t *tree, ast_ref_t ref) {
+	uint32_t token = ast_get(tree, ref)->token;
+	if(token == AST_NO_TOKEN) return EMPTY_STRING;
+	char *start = &tree->src.string[tree->tokens->starts[token]];
+	return CONSTRUCT_STR(tree->tokens->lengths[token], start);
 }
 
-ast_t ast_tree_new(void) {
-	return (ast_t) {
-		.arena = arena_new(64),
-		.root = NULL
+symbol_t ast_node_symbol(const ast_t *tree, ast_ref_t ref) {
+	uint32_t token = ast_get(tree, ref)->token;
+	if(token == AST_NO_TOKEN) return NO_SYMBOL;
+	return tree->tokens->symbols[token];
+}
+
+void *ast_side_array(ast_t *tree, size_t unit_size) {
+	size_t size_bytes = tree->nodes.count * unit_size;
+	void *array = arena_alloc(&tree->arena, size_bytes);
+	error_if(array == NULL);
+	memset(array, 0, size_bytes);
+	return array;
+}
+
+ast_t ast_tree_new(const token_buffer_t *tokens, string_t src) {
+	ast_t tree = {
+		.tokens = tokens, .src = src,
+		.nodes = ast_node_list_new(NULL, 256),
+		.lists = ast_ref_list_new(NULL, 256),
+		.root = AST_NONE, .decls = NULL, .types = NULL,
+		.folded = NULL, .values = NULL,
+		.arena = arena_new_raw(4096)
 	};
+	// Take up the slot of `AST_NONE` so that no node can be referred by it
+	add_node(&tree, (ast_node_t) {.type = AST_ERROR, .token = AST_NO_TOKEN});
+	return tree;
 }
 
 void ast_tree_free(ast_t *tree) {
+	ast_node_list_free(&tree->nodes);
+	ast_ref_list_free(&tree->lists);
 	arena_free(&tree->arena);
-	tree->root = NULL;
+	tree->root = AST_NONE, tree->decls = NULL, tree->types = NULL;
+	tree->folded = NULL, tree->values = NULL;
 }
-
-#define INITIAL_BUFFER_SIZE 16
-void ast_tree_visualize(ast_t *tree) {
-	char *initial_buffer  = (char *) calloc(INITIAL_BUFFER_SIZE, sizeof(char));
-	string_t prefix = {.size = INITIAL_BUFFER_SIZE, .string = initial_buffer};
-	visualizer_walker(tree->root, 0, &prefix, false); printf("\x1b[0m");
-	free(prefix.string);
-}
\ No newline at end of file
@@ -0,0 +1,214 @@
+// Needed for fileno and isatty under strict C99
+#define _DEFAULT_SOURCE
+
+#include "dump.h"
+#include "visitor.h"
+
+#include "common/vector.h"
+#include "frontend/error.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DUMP_BUFFER_SIZE (64 * 1024)
+#define TYPE_COLUMN_WIDTH 12
+
+VECTOR_DEFINE(flag_stack, bool)
+
+typedef struct dump_state {
+	FILE *out;
+	bool color;
+	/// Whether the next node is the first among its siblings.
+	bool first;
+	/// Whether each ancestor of the current node has siblings left after it.
+	flag_stack_t more;
+	size_t used;
+	char buffer[DUMP_BUFFER_SIZE];
+} dump_state_t;
+
+// Internal Functions (Output) //
+
+static void flush(dump_state_t *ds) {
+	if(ds->used == 0) return;
+	error_if(fwrite(ds->buffer, 1, ds->used, ds->out) != ds->used);
+	ds->used = 0;
+}
+
+static void write_bytes(dump_state_t *ds, const char *bytes, size_t size) {
+	// Empty strings may not point anywhere
+	if(size == 0) return;
+	if(size > DUMP_BUFFER_SIZE - ds->used) {
+		flush(ds);
+		// Too big to be worth buffering, can only be very long tokens
+		if(size > DUMP_BUFFER_SIZE) {
+			error_if(fwrite(bytes, 1, size, ds->out) != size);
+			return;
+		}
+	}
+	memcpy(&ds->buffer[ds->used], bytes, size);
+	ds->used += size;
+}
+
+#define write_literal(ds, literal) write_bytes(ds, literal, sizeof(literal) - 1)
+
+static void write_string(dump_state_t *ds, const char *string) {
+	write_bytes(ds, string, strlen(string));
+}
+
+static void write_color(dump_state_t *ds, const char *escape) {
+	if(ds->color) write_string(ds, escape);
+}
+
+static void write_quoted(dump_state_t *ds, string_t string) {
+	// Tokens never contain anything that needs escaping other than by
+	// mistake, so escape the few characters that break both formats
+	write_literal(ds, "\"");
+	for(size_t i=0; i<string.size; i++) {
+		unsigned char c = (unsigned char) string.string[i];
+		if(c == '"' || c == '\\') {
+			char escaped[2] = {'\\', (char) c};
+			write_bytes(ds, escaped, 2);
+		} else if(c < 0x20) {
+			char escaped[7];
+			snprintf(escaped, sizeof escaped, "\\u%04x", c);
+			write_bytes(ds, escaped, 6);
+		} else write_bytes(ds, (char *) &c, 1);
+	}
+	write_literal(ds, "\"");
+}
+
+// Internal Functions (Formats) //
+
+static dump_state_t *state(const ast_visit_t *visit) {
+	return (dump_state_t *) visit->context;
+}
+
+static bool has_children(const ast_visit_t *visit) {
+	size_t count = ast_child_count(visit->tree, visit->node);
+	for(size_t i=0; i<count; i++)
+		if(ast_child(visit->tree, visit->node, i) != AST_NONE) return true;
+	return false;
+}
+
+static bool leading_gap(const ast_visit_t *visit) {
+	// A pair with only its right child, which would look like the left one
+	ast_node_t *node = ast_get(visit->tree, visit->node);
+	return node->type < AST_FIRST_LIST_NODE
+		&& node->children.pair.left == AST_NONE
+		&& node->children.pair.right != AST_NONE;
+}
+
+static bool tree_enter(const ast_visit_t *visit) {
+	dump_state_t *ds = state(visit);
+	if(visit->depth > 0) {
+		// Note: This whitespace-looking character is actually U+2800
+		// also known as Braille Pattern Blank. Can't use a normal space
+		// because all of the prefix characters have to be the same size.
+		for(size_t i=1; i<visit->depth; i++) {
+			write_color(ds, "\x1b[0;32m");
+			if(ds->more.data[i]) write_literal(ds, "│ ");
+			else write_literal(ds, "⠀ ");
+		}
+		write_color(ds, "\x1b[0;32m");
+		if(visit->last) write_literal(ds, "└ ");
+		else write_literal(ds, "├ ");
+	}
+
+	// Remember for the descendants whether more siblings follow this node
+	ds->more.count = visit->depth;
+	flag_stack_push(&ds->more, !visit->last);
+
+	const char *type = node_type_strs[ast_get(visit->tree, visit->node)->type];
+	string_t content = ast_node_content(visit->tree, visit->node);
+	write_color(ds, "\x1b[33m");
+	write_string(ds, type);
+	for(size_t i=strlen(type); i<TYPE_COLUMN_WIDTH; i++) write_literal(ds, " ");
+	write_literal(ds, " ");
+	write_bytes(ds, content.string, content.size);
+	write_literal(ds, "\n");
+	return true;
+}
+
+static bool sexpr_enter(const ast_visit_t *visit) {
+	dump_state_t *ds = state(visit);
+	if(visit->depth > 0) write_literal(ds, " ");
+	write_literal(ds, "(");
+	write_string(ds, node_type_strs[ast_get(visit->tree, visit->node)->type]);
+	if(ast_get(visit->tree, visit->node)->token != AST_NO_TOKEN) {
+		write_literal(ds, " ");
+		write_quoted(ds, ast_node_content(visit->tree, visit->node));
+	}
+	if(leading_gap(visit)) write_literal(ds, " ()");
+	return true;
+}
+
+static void sexpr_leave(const ast_visit_t *visit) {
+	write_literal(state(visit), ")");
+}
+
+static bool json_enter(const ast_visit_t *visit) {
+	dump_state_t *ds = state(visit);
+	if(!ds->first) write_literal(ds, ",");
+	write_literal(ds, "{\"type\":\"");
+	write_string(ds, node_type_strs[ast_get(visit->tree, visit->node)->type]);
+	write_literal(ds, "\"");
+	if(ast_get(visit->tree, visit->node)->token != AST_NO_TOKEN) {
+		write_literal(ds, ",\"text\":");
+		write_quoted(ds, ast_node_content(visit->tree, visit->node));
+	}
+
+	ds->first = true;
+	if(!has_children(visit)) return true;
+	write_literal(ds, ",\"children\":[");
+	if(leading_gap(visit)) write_literal(ds, "null"), ds->first = false;
+	return true;
+}
+
+static void json_leave(const ast_visit_t *visit) {
+	dump_state_t *ds = state(visit);
+	if(has_children(visit)) write_literal(ds, "]");
+	write_literal(ds, "}");
+	ds->first = false;
+}
+
+// External Functions //
+
+bool ast_dump_parse_format(const char *name, ast_dump_format_t *format) {
+	if(strcmp(name, "tree") == 0) *format = AST_DUMP_TREE;
+	else if(strcmp(name, "sexpr") == 0) *format = AST_DUMP_SEXPR;
+	else if(strcmp(name, "json") == 0) *format = AST_DUMP_JSON;
+	else return false;
+	return true;
+}
+
+void ast_dump(ast_t *tree, FILE *out, ast_dump_format_t format) {
+	dump_state_t *ds = (dump_state_t *) malloc(sizeof(dump_state_t));
+	error_if(ds == NULL);
+	ds->out = out, ds->used = 0, ds->first = true;
+	ds->color = format == AST_DUMP_TREE && isatty(fileno(out));
+	ds->more = flag_stack_new(NULL, 64);
+
+	ast_visitor_t visitor = {.context = ds};
+	for(size_t i=0; i<AST_NODE_COUNT; i++) switch(format) {
+		case AST_DUMP_TREE:
+			visitor.pre[i] = tree_enter;
+			break;
+		case AST_DUMP_SEXPR:
+			visitor.pre[i] = sexpr_enter;
+			visitor.post[i] = sexpr_leave;
+			break;
+		case AST_DUMP_JSON:
+			visitor.pre[i] = json_enter;
+			visitor.post[i] = json_leave;
+			break;
+	}
+
+	ast_walk(tree, tree->root, &visitor);
+	if(format != AST_DUMP_TREE) write_literal(ds, "\n");
+	write_color(ds, "\x1b[0m");
+	flush(ds);
+
+	flag_stack_free(&ds->more);
+	free(ds);
+}
@@ -1,367 +1,351 @@
 #include "ast.h"
-#include "lookaheads.h"
 #include "parser.h"
 
 #include "common/strslice.h"
 #include "common/vector.h"
 #include "frontend/error.h"
 #include "frontend/lexical/lexer.h"
+#include "frontend/syntactic/lookaheads.h"
 
-#include <stdarg.h>
+#include <setjmp.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define PEEK lexer_peek()->type
-#define CONSUME lexer_next()
+#include "frontend/syntactic/parse_table.c"
 
-static struct parser_state {
+#define PEEK lexer_peek(ps->lexer)
+#define CONSUME lexer_next(ps->lexer)
+#define CURRENT lexer_get(ps->lexer, lexer_tell(ps->lexer))
+
+/// An operator whose right operand is being parsed, see `LL_HOOK_INFIX`.
+typedef struct pending_operator {
+	/// The `AST_OP_UNARY` or `AST_OP_BINARY` the operand is going into, or
+	/// `AST_NONE` for the start of an expression.
+	ast_ref_t node;
+	/// The limit of the operand the operator is part of, restored once done.
+	uint8_t limit;
+} pending_operator_t;
+
+VECTOR_DEFINE(operator_stack, pending_operator_t)
+VECTOR_DEFINE(list_starts, size_t)
+
+typedef struct parser {
+	lexer_t *lexer;
+	error_sink_t *errors;
 	string_file_t file;
 	ast_t *ast;
-} ps;
+	// The symbols of the grammar left to parse, see `ll_parse`.
+	ll_stack_t symbols;
+	// The last token matched by the grammar, which the hooks build from.
+	token_t last;
+	// The nodes the hooks are building, used as a stack.
+	ast_ref_list_t values;
+	// The children of the lists being parsed, moved into the tree once
+	// each list is complete so that it ends up contiguous.
+	ast_ref_list_t pending;
+	// Where the children of each list being parsed start in `pending`.
+	list_starts_t starts;
+	// The operators waiting for their right operand, used as a stack.
+	operator_stack_t operators;
+	// How strongly the operator the current operand belongs to binds it.
+	uint8_t limit;
+	// Set by the first error until the next statement starts, the errors
+	// in between are most likely caused by it and are not reported.
+	bool panicking;
+} parser_t;
+
+// The tokens to skip ahead to after an error, each one also stops at EOF
+typedef enum sync_set {
+	// Whatever can follow an expression or start the next statement.
+	SYNC_EXPRESSION,
+	// Whatever can start or end a statement.
+	SYNC_STATEMENT
+} sync_set_t;
 
 // Internal Functions (Helpers) //
 
-/* WIP
-static void skip_until(size_t count, ...) {
-	va_list token_types;
-	for(bool found = false; !found; ) {
-		va_start(token_types, count);
-		for(size_t i=0; i<count; i++) {
-			token_type_t sample = va_arg(token_types, token_type_t);
-			if(PEEK == sample) { found = true; break; }
-		}
-		if(!found) CONSUME;
-		if(PEEK == TOK_EOF) found = true;
-		va_end(token_types);
+static bool in_sync_set(token_type_t type, sync_set_t set) {
+	if(set == SYNC_EXPRESSION) switch(type) {
+		case EXPR_FOLLOWS: return true;
+		default: ;
+	}
+	switch(type) {
+		case TOK_EOF:
+		case STMT_FIRSTS:
+		case TOK_KW_VAR:
+		case TOK_SEMICOLON:
+		case TOK_KW_END:
+		case TOK_KW_ELIF:
+		case TOK_KW_ELSE:
+			return true;
+		default: return false;
 	}
 }
-*/
 
-static void report(token_t *problem, char *message) {
-	string_t error_spot = problem->content;
+static void skip_until(parser_t *ps, sync_set_t set) {
+	while(!in_sync_set(PEEK, set)) CONSUME;
+}
+
+static void report(parser_t *ps, token_t problem, char *message) {
+	if(ps->panicking) return;
+	ps->panicking = true;
+	string_t error_spot = problem.content;
 	string_t error_message = CONSTRUCT_STR(strlen(message), message);
-	error_t error_descriptor = err_new(ps.file, error_spot, error_message);
-	err_submit(error_descriptor, problem->type == TOK_EOF);
+	error_t error_descriptor = err_new(ps->file, error_spot, error_message);
+	err_submit(ps->errors, error_descriptor, false);
 }
 
-static token_t *expect(token_type_t type) {
-	token_t *next = CONSUME;
-	if(next->type != type) {
-		string_t error_spot = next->content;
+/** Reports the current token and skips ahead to the nearest token of a set,
+  * which is left for the caller to pick up from.
+  * @return The token that was reported.
+  */
+static token_t recover(parser_t *ps, char *message, sync_set_t set) {
+	token_t errant = CURRENT;
+	report(ps, errant, message);
+	skip_until(ps, set);
+	return errant;
+}
+
+/** Consumes a token of the given type. When the next token is not one, the
+  * tokens up to the first one that is are skipped, unless a token that can
+  * start or end a statement comes first, in which case the expected one is
+  * taken to be missing and nothing more is consumed.
+  * @return The expected token, or the one reported in its place.
+  */
+static token_t expect(parser_t *ps, token_type_t type) {
+	if(PEEK == type) return CONSUME;
+	token_t next = CURRENT;
+	if(!ps->panicking) {
 		size_t message_length = sizeof "Expected " + strlen(token_type_strs[type]);
-		char *message_string = arena_alloc(err_get_arena(), message_length);
+		char *message_string = arena_alloc(err_get_arena(ps->errors), message_length);
 		snprintf(message_string, message_length, "Expected %s", token_type_strs[type]);
-		string_t error_message = CONSTRUCT_STR(message_length, message_string);
-		error_t error_descriptor = err_new(ps.file, error_spot, error_message);
-		err_submit(error_descriptor, false);
+		report(ps, next, message_string);
 	}
-	return next;
+	while(PEEK != type && !in_sync_set(PEEK, SYNC_STATEMENT)) CONSUME;
+	if(PEEK != type) return next;
+	// Found what it was looking for, so back in sync
+	ps->panicking = false;
+	return CONSUME;
 }
 
-// Internal Function Decls (Non-Terminals) //
-
-static ast_node_t *parse_block(void);
-static ast_node_t *parse_type(void);
-static ast_node_t *parse_statement(bool inner);
+static void value_push(parser_t *ps, ast_ref_t node) {
+	ast_ref_list_push(&ps->values, node);
+}
 
-static ast_node_t *parse_expression(arena_t *reused_arena);
-static ast_node_t *parse_term(arena_t *reused_arena);
+static ast_ref_t value_pop(parser_t *ps) {
+	return ast_ref_list_pop(&ps->values);
+}
 
-// Internal Function Defs (Non-Terminal Helpers) //
+static ast_ref_t value_top(parser_t *ps) {
+	return *ast_ref_list_peek(&ps->values);
+}
 
-typedef struct operator {
-	token_t *token;
-	unsigned prec;
-	bool unary;
-	bool left;
-} operator_t;
+/// Starts a list node, whose children are added to it with `list_add`.
+static void list_begin(parser_t *ps, ast_ref_t list) {
+	value_push(ps, list);
+	list_starts_push(&ps->starts, ps->pending.count);
+}
 
-static operator_t sy_get_binop(void) {
-	token_t *token = CONSUME;
-	operator_t ret = {.token = token, .prec = 0, .unary = false, .left = false};
-	switch(token->type) {
-		case TOK_OP_ASSIGN:
-		case TOK_OP_ASSIGN_ALT:
-			ret.prec = 5;
-			ret.left = true;
-			break;
-		case TOK_KW_AND:
-		case TOK_KW_OR:
-			ret.prec = 4;
-			break;
-		case TOK_OP_COMPARE:
-			ret.prec = 3;
-			break;
-		case TOK_OP_PLUS:
-		case TOK_OP_MINUS:
-			ret.prec = 2;
-			break;
-		case TOK_OP_MULT:
-		case TOK_OP_DIV:
-		case TOK_OP_MOD:
-			ret.prec = 1;
-			break;
-		default: report(token, "a valid binary operator");
-	}
-	return ret;
+static void list_add(parser_t *ps, ast_ref_t child) {
+	ast_ref_list_push(&ps->pending, child);
 }
 
-static operator_t sy_get_unop(void) {
-	operator_t ret = {.token = NULL, .prec = 0, .unary = true, .left = true};
-	switch(PEEK) {
-		case TOK_KW_NOT:
-			ret.token = CONSUME;
-			ret.prec = 4;
-			break;
-		case TOK_OP_PLUS:
-		case TOK_OP_MINUS:
-			ret.token = CONSUME;
-			ret.prec = 1;
-			break;
-		case TERM_FIRSTS:
-			break;
-		default: report(CONSUME, "a valid unary operator");
-	}
-	return ret;
+/// Completes the most recently started list node, leaving it as a value.
+static void list_commit(parser_t *ps) {
+	size_t begin = list_starts_pop(&ps->starts);
+	ast_lnode_set(ps->ast, value_top(ps), &ps->pending.data[begin], ps->pending.count - begin);
+	ps->pending.count = begin;
 }
 
-static void sy_pop_operator(vector_t **output, vector_t **opstack) {
-	operator_t old_op; vector_take(*opstack, &old_op);
-	ast_node_type_t node_type = old_op.unary ? AST_OP_UNARY : AST_OP_BINARY;
-	ast_node_t *node = ast_pnode_new(ps.ast, node_type, old_op.token->content);
-
-	ast_node_t *tmp = NULL;
-	vector_take(*output, &tmp);
-	ast_pnode_right(node, tmp);
-	if(!old_op.unary) {
-		vector_take(*output, &tmp);
-		ast_pnode_left(node, tmp);
-	}
+// Internal Functions (Operators) //
+
+/** How strongly each operator token binds its operands, higher binds
+  * tighter and 0 means that the token is not an operator in that position.
+  * Adding an operator to the language only takes a line here, besides its
+  * token in the `bop` or `uop` terminal of the grammar.
+  */
+static const struct binding_power {
+	/// The power of the token as a unary operator before its operand.
+	uint8_t prefix;
+	/// The power of the token as a binary operator between its operands.
+	uint8_t infix;
+	/// Whether chains of the binary operator group from the right.
+	bool right;
+} binding_powers[TOK_TYPE_COUNT] = {
+	[TOK_OP_ASSIGN] = {0, 1, true}, [TOK_OP_ASSIGN_ALT] = {0, 1, true},
+	[TOK_KW_AND] = {0, 2, false}, [TOK_KW_OR] = {0, 2, false},
+	[TOK_KW_NOT] = {2, 0, false},
+	[TOK_OP_COMPARE] = {0, 3, false},
+	[TOK_OP_PLUS] = {5, 4, false}, [TOK_OP_MINUS] = {5, 4, false},
+	[TOK_OP_MULT] = {0, 5, false}, [TOK_OP_DIV] = {0, 5, false},
+	[TOK_OP_MOD] = {0, 5, false}
+};
+
+static void operator_begin(parser_t *ps, ast_ref_t node, uint8_t power) {
+	operator_stack_push(&ps->operators, (pending_operator_t) {.node = node, .limit = ps->limit});
+	ps->limit = power;
+}
 
-	vector_add(output, &node);
+/// Makes a complete operand the right operand of the operator waiting for it.
+static ast_ref_t operator_complete(parser_t *ps, ast_ref_t operand) {
+	pending_operator_t done = operator_stack_pop(&ps->operators);
+	ast_pnode_right(ps->ast, done.node, operand);
+	ps->limit = done.limit;
+	return done.node;
 }
 
-static ast_node_t *shunting_yard(arena_t *arena) {
-	bool atom = true;
-	vector_t *output = vector_new(arena, sizeof(ast_node_t *), 16);
-	vector_t *opstack = vector_new(arena, sizeof(operator_t), 16);
-
-	while(true) {
-		switch(PEEK) {
-			case EXPR_FOLLOWS: goto exit;
-			default: ;
-		}
-
-		if(atom) {
-			operator_t new_op = sy_get_unop();
-			if(new_op.prec == 0) {
-				ast_node_t *new_atom = parse_term(arena);
-				vector_add(&output, &new_atom);
-				atom = false;
-			} else vector_add(&opstack, &new_op);
-		} else {
-			operator_t new_op = sy_get_binop();
-			while(opstack->count > 0 && (new_op.left ?
-				((operator_t *) vector_peek(opstack))->prec < new_op.prec :
-				((operator_t *) vector_peek(opstack))->prec <= new_op.prec
-			)) sy_pop_operator(&output, &opstack);
-			vector_add(&opstack, &new_op);
-			atom = true;
-		}
-	} exit: ;
-
-	if(atom) {
-		token_t *errant = CONSUME;
-		report(errant, "another expression term");
-		ast_node_t *errant_node = ast_pnode_new(ps.ast, AST_ERROR, errant->content);
-		vector_add(&output, &errant_node);
-	}
+// Internal Functions (Grammar) //
 
-	for(size_t i=0, size = opstack->count; i<size; i++) sy_pop_operator(&output, &opstack);
-	if(output->count != 1) report(CONSUME, "a well-formed expression");
-	ast_node_t *expr; vector_take(output, &expr);
-	return expr;
+static token_type_t ll_peek(parser_t *ps) {
+	return PEEK;
 }
 
-static ast_node_t *statement_or_expression(bool inner_stmt, bool sem_expr) {
-	ast_node_t *node = NULL;
-	switch(PEEK) {
-		case STMT_FIRSTS:
-			node = parse_statement(inner_stmt);
-			break;
-		case EXPR_FIRSTS:
-			node = parse_expression(NULL);
-			if(sem_expr) expect(TOK_SEMICOLON);
-			break;
-		default: report(CONSUME, "statement or expression");
-	}
-	return node;
+static void ll_match(parser_t *ps, token_type_t type) {
+	ps->last = expect(ps, type);
 }
 
-static ast_node_t *enclosed_block(bool with_end) {
-	string_t content = expect(TOK_KW_DO)->content;
-	ast_node_t *node = parse_block();
-	node->content = content;
-	if(with_end) expect(TOK_KW_END);
-	return node;
+static void ll_match_any(parser_t *ps) {
+	ps->last = CONSUME;
 }
 
-static ast_node_t *statement_content(bool with_end) {
-	ast_node_t *node = NULL;
-	switch(PEEK) {
-		case TOK_COLON: CONSUME;
-			node = statement_or_expression(true, false);
-			if(with_end) expect(TOK_KW_END);
+/** Builds the tree as the grammar goes. Each production leaves the node it
+  * parsed on top of the values, which the hooks that come after it in the
+  * grammar take to put into their own nodes.
+  */
+static void ll_hook(parser_t *ps, ll_hook_t hook) {
+	uint32_t token = ps->last.index;
+	switch(hook) {
+		case LL_HOOK_BLOCK:
+			list_begin(ps, ast_lnode_new(ps->ast, AST_BLOCK, AST_NO_TOKEN));
 			break;
-		case TOK_KW_DO:
-			node = enclosed_block(with_end);
+		case LL_HOOK_DO_BLOCK:
+			list_begin(ps, ast_lnode_new(ps->ast, AST_BLOCK, token));
+			break;
+		case LL_HOOK_VAR_LIST:
+			list_begin(ps, ast_lnode_new(ps->ast, AST_VAR_LIST, token));
+			break;
+		case LL_HOOK_IF:
+			list_begin(ps, ast_lnode_new(ps->ast, AST_IF_LIST, AST_NO_TOKEN));
+			break;
+		case LL_HOOK_CALL:
+			list_begin(ps, ast_lnode_new(ps->ast, AST_CALL, token));
+			break;
+		case LL_HOOK_ADD: list_add(ps, value_pop(ps)); break;
+		case LL_HOOK_COMMIT: list_commit(ps); break;
+
+		case LL_HOOK_VAR: value_push(ps, ast_pnode_new(ps->ast, AST_VAR_SINGLE, token)); break;
+		case LL_HOOK_TYPE: value_push(ps, ast_pnode_new(ps->ast, AST_TYPE, token)); break;
+		case LL_HOOK_RETURN: value_push(ps, ast_pnode_new(ps->ast, AST_RETURN, token)); break;
+		case LL_HOOK_WHILE: value_push(ps, ast_pnode_new(ps->ast, AST_WHILE, token)); break;
+		case LL_HOOK_BRANCH: value_push(ps, ast_pnode_new(ps->ast, AST_IF_SINGLE, token)); break;
+		case LL_HOOK_LITERAL: value_push(ps, ast_pnode_new(ps->ast, AST_LITERAL, token)); break;
+		case LL_HOOK_IDENT: value_push(ps, ast_pnode_new(ps->ast, AST_IDENT, token)); break;
+		case LL_HOOK_NONE: value_push(ps, AST_NONE); break;
+		case LL_HOOK_LEFT: ;
+			ast_ref_t left = value_pop(ps);
+			ast_pnode_left(ps->ast, value_top(ps), left);
+			break;
+		case LL_HOOK_RIGHT: ;
+			ast_ref_t right = value_pop(ps);
+			ast_pnode_right(ps->ast, value_top(ps), right);
 			break;
-		default: report(CONSUME, "\":\" or inline block");
-	}
-	return node;
-}
-
-// Internal Functions Defs (Non-Terminals) //
 
-static ast_node_t *parse_block(void) {
-	ast_node_t *node = ast_lnode_new(ps.ast, 4, AST_BLOCK, EMPTY_STRING);
-	while(true) switch(PEEK) {
-		case STMT_FIRSTS:
-		case EXPR_FIRSTS:
-			node = ast_lnode_add(ps.ast, node, statement_or_expression(false, true));
+		// Operators wait on a stack of the parser for their right operand,
+		// the ones that bind tighter than the next one are done by then
+		case LL_HOOK_EXPR: operator_begin(ps, AST_NONE, 0); break;
+		case LL_HOOK_PREFIX:
+			operator_begin(ps, ast_pnode_new(ps->ast, AST_OP_UNARY, token),
+				binding_powers[ps->last.type].prefix);
+			break;
+		case LL_HOOK_INFIX: ;
+			const struct binding_power *power = &binding_powers[ps->last.type];
+			ast_ref_t operand = value_pop(ps);
+			while(power->infix < ps->limit || (power->infix == ps->limit && !power->right))
+				operand = operator_complete(ps, operand);
+			ast_ref_t binary = ast_pnode_new(ps->ast, AST_OP_BINARY, token);
+			ast_pnode_left(ps->ast, binary, operand);
+			operator_begin(ps, binary, power->infix);
 			break;
-		case TOK_KW_VAR: ;
-			ast_node_t *varlist = ast_lnode_new(ps.ast, 4, AST_VAR_LIST, CONSUME->content);
-			while(true) {
-				string_t identifier = expect(TOK_IDENT)->content;
-				ast_node_t *variable = ast_pnode_new(ps.ast, AST_VAR_SINGLE, identifier);
-				ast_pnode_left(variable, parse_type());
-				expect(TOK_OP_ASSIGN);
-
-				bool expr;
-				switch(PEEK) {
-					case EXPR_FIRSTS: expr = true; break;
-					default: expr = false; break;
-				}
-
-				ast_pnode_right(variable, statement_or_expression(false, false));
-				varlist = ast_lnode_add(ps.ast, varlist, variable);
-
-				if(PEEK != TOK_COMMA) {
-					if(expr) expect(TOK_SEMICOLON);
+		case LL_HOOK_EXPR_END: ;
+			ast_ref_t node = value_pop(ps);
+			while(operator_stack_peek(&ps->operators)->node != AST_NONE)
+				node = operator_complete(ps, node);
+			ps->limit = operator_stack_pop(&ps->operators).limit;
+			value_push(ps, node);
+			// Whatever stopped the operators has to be able to follow an expression
+			switch(PEEK) {
+				case EXPR_FOLLOWS:
+				case TOK_EOF:
 					break;
-				} else CONSUME;
+				default: recover(ps, "a valid binary operator", SYNC_EXPRESSION);
 			}
-			node = ast_lnode_add(ps.ast, node, varlist);
 			break;
-		case TOK_EOF:
-		case TOK_KW_END:
-		case TOK_KW_ELSE:
-		case TOK_KW_ELIF:
-			goto exit;
-		default: report(CONSUME, "a statement or an expression");
-	} exit: ;
-	return node;
-}
-
-static ast_node_t *parse_type(void) {
-	if(PEEK != TOK_COLON) return NULL;
-	CONSUME;
-	switch(PEEK) {
-		case TOK_TYPE_NAT:
-		case TOK_TYPE_INT:
-		case TOK_TYPE_BOOL:
-			return ast_pnode_new(ps.ast, AST_TYPE, CONSUME->content);
-		default: report(CONSUME, "a valid type");
-	}
-	return NULL;
-}
 
-static ast_node_t *parse_statement(bool inner_stmt) {
-	ast_node_t *node = NULL;
-	switch(PEEK) {
-		case TOK_KW_DO:
-			node = enclosed_block(true);
+		// Errors, the missing node is left as `AST_NONE` or `AST_ERROR`
+		case LL_HOOK_RESUME: ps->panicking = false; break;
+		case LL_HOOK_STRAY:
+			// A run of tokens that can not start anything is reported once
+			report(ps, CONSUME, "a statement or an expression");
 			break;
-		case TOK_KW_RETURN:
-			node = ast_pnode_new(ps.ast, AST_RETURN, CONSUME->content);
-			ast_pnode_left(node, statement_or_expression(inner_stmt, !inner_stmt));
+		case LL_HOOK_MISSING_STATEMENT:
+			recover(ps, "statement or expression", SYNC_EXPRESSION);
+			value_push(ps, AST_NONE);
 			break;
-		case TOK_KW_WHILE:
-			node = ast_pnode_new(ps.ast, AST_WHILE, CONSUME->content);
-			ast_pnode_left(node, statement_or_expression(true, false));
-			ast_pnode_right(node, statement_content(true));
+		case LL_HOOK_MISSING_CONTENT:
+			recover(ps, "\":\" or inline block", SYNC_STATEMENT);
+			value_push(ps, AST_NONE);
 			break;
-		case TOK_KW_IF:
-			node = ast_lnode_new(ps.ast, 4, AST_IF_LIST, EMPTY_STRING);
-			for(bool else_next = false; ; ) {
-				ast_node_t *branch = ast_pnode_new(ps.ast, AST_IF_SINGLE, CONSUME->content);
-				if(!else_next) ast_pnode_left(branch, statement_or_expression(true, false));
-				ast_pnode_right(branch, statement_content(false));
-				node = ast_lnode_add(ps.ast, node, branch);
-
-				if(else_next) break;
-				token_type_t next = PEEK;
-				if(next == TOK_KW_ELSE) else_next = true;
-				else if(next != TOK_KW_ELIF) break;
+		case LL_HOOK_MISSING_TYPE:
+			recover(ps, "a valid type", SYNC_EXPRESSION);
+			value_push(ps, AST_NONE);
+			break;
+		case LL_HOOK_MISSING_TERM: ;
+			token_t errant;
+			switch(PEEK) {
+				case EXPR_FOLLOWS:
+				case TOK_EOF:
+					// The token is left for whatever follows the expression
+					errant = CURRENT;
+					report(ps, errant, "another expression term");
+					break;
+				default: errant = recover(ps, "an expression term.", SYNC_EXPRESSION);
 			}
-			expect(TOK_KW_END);
+			value_push(ps, ast_pnode_new(ps->ast, AST_ERROR, errant.index));
 			break;
-		default: ;
 	}
-	return node;
-}
-
-static ast_node_t *parse_expression(arena_t *reused_arena) {
-	arena_t *arena;
-	if(reused_arena == NULL) {
-		arena_t new_arena = arena_new(1024);
-		arena = &new_arena;
-	} else arena = reused_arena;
-	ast_node_t *node = shunting_yard(arena);
-	if(reused_arena == NULL) arena_free(arena);
-	return node;
 }
 
-static ast_node_t *parse_term(arena_t *reused_arena) {
-	ast_node_t *node = NULL;
-	switch(PEEK) {
-		case TOK_LIT_NUM:
-		case TOK_KW_TRUE:
-		case TOK_KW_FALSE:
-		case TOK_KW_NIL:
-			node = ast_pnode_new(ps.ast, AST_LITERAL, CONSUME->content);
-			break;
-		case TOK_OPEN_ROUND: CONSUME;
-			node = parse_expression(reused_arena);
-			expect(TOK_CLOSE_ROUND);
-			break;
-		case TOK_IDENT: ;
-			string_t content = CONSUME->content;
-			if(PEEK == TOK_OPEN_ROUND) { CONSUME;
-				node = ast_lnode_new(ps.ast, 4, AST_CALL, content);
-				if(PEEK != TOK_CLOSE_ROUND) while(true) {
-					node = ast_lnode_add(ps.ast, node, statement_or_expression(true, false));
-					if(PEEK != TOK_CLOSE_ROUND) expect(TOK_COMMA);
-					else break;
-				}
-				expect(TOK_CLOSE_ROUND);
-			} else node = ast_pnode_new(ps.ast, AST_IDENT, content);
-			break;
-		default: ;
-			token_t *errant = CONSUME;
-			report(errant, "an expression term.");
-			node = ast_pnode_new(ps.ast, AST_ERROR, errant->content);
-	}
-	return node;
+static bool parse_guarded(parser_t *ps) {
+	// Fatal errors jump back here, leaving the tree without a root
+	jmp_buf bail;
+	ps->errors->bail = &bail;
+	if(setjmp(bail) != 0) return false;
+	ll_parse(ps, &ps->symbols, LL_PROGRAM);
+	ps->ast->root = value_pop(ps);
+	return true;
 }
 
 // External Functions //
 
-void parser_run(string_file_t file, ast_t *tree) {
-	ps.file = file, ps.ast = tree;
-	ast_node_t *root = parse_block();
-	expect(TOK_EOF);
-	tree->root = root;
+bool parser_run(lexer_t *lexer, error_sink_t *errors, ast_t *tree) {
+	parser_t parser = {
+		.lexer = lexer, .errors = errors,
+		.file = lexer->file, .ast = tree,
+		.symbols = ll_stack_new(NULL, 64),
+		.values = ast_ref_list_new(NULL, 64),
+		.pending = ast_ref_list_new(NULL, 64),
+		.starts = list_starts_new(NULL, 16),
+		.operators = operator_stack_new(NULL, 16),
+		.limit = 0,
+		.panicking = false
+	};
+	bool complete = parse_guarded(&parser);
+	errors->bail = NULL;
+	ll_stack_free(&parser.symbols);
+	ast_ref_list_free(&parser.values);
+	ast_ref_list_free(&parser.pending);
+	list_starts_free(&parser.starts);
+	operator_stack_free(&parser.operators);
+	return complete;
 }
@@ -0,0 +1,71 @@
+#include "visitor.h"
+
+#include "common/vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** A node whose subtree is being walked. The frames of the stack are the
+  * chain of ancestors of the node currently visited.
+  */
+typedef struct frame {
+	ast_visit_t visit;
+	/// The slot of the next child to visit, the child count once done.
+	size_t next;
+	size_t count;
+} frame_t;
+
+VECTOR_DEFINE(frame_stack, frame_t)
+
+// Internal Functions //
+
+static size_t skip_empty(ast_t *tree, ast_ref_t node, size_t slot, size_t count) {
+	while(slot < count && ast_child(tree, node, slot) == AST_NONE) slot++;
+	return slot;
+}
+
+static void enter(frame_stack_t *stack, const ast_visitor_t *visitor, ast_visit_t visit) {
+	ast_node_type_t type = ast_get(visit.tree, visit.node)->type;
+	frame_t frame = {.visit = visit, .next = 0, .count = 0};
+	bool descend = visitor->pre[type] == NULL || visitor->pre[type](&visit);
+	if(descend) {
+		frame.count = ast_child_count(visit.tree, visit.node);
+		frame.next = skip_empty(visit.tree, visit.node, 0, frame.count);
+	}
+	frame_stack_push(stack, frame);
+}
+
+// External Functions //
+
+void ast_walk(ast_t *tree, ast_ref_t root, const ast_visitor_t *visitor) {
+	if(root == AST_NONE) return;
+	frame_stack_t stack = frame_stack_new(NULL, 64);
+	enter(&stack, visitor, (ast_visit_t) {
+		.tree = tree, .node = root, .parent = AST_NONE,
+		.depth = 0, .last = true, .context = visitor->context
+	});
+
+	while(stack.count > 0) {
+		frame_t *top = frame_stack_peek(&stack);
+		if(top->next == top->count) {
+			// Every child is done, leave the node
+			frame_t done = frame_stack_pop(&stack);
+			ast_node_type_t type = ast_get(tree, done.visit.node)->type;
+			if(visitor->post[type] != NULL) visitor->post[type](&done.visit);
+			continue;
+		}
+
+		// Look past the child for the one after it to know if it is the last
+		ast_ref_t parent = top->visit.node;
+		ast_ref_t child = ast_child(tree, parent, top->next);
+		top->next = skip_empty(tree, parent, top->next + 1, top->count);
+		// `top` is invalidated once something is pushed
+		enter(&stack, visitor, (ast_visit_t) {
+			.tree = tree, .node = child, .parent = parent,
+			.depth = top->visit.depth + 1, .last = top->next == top->count,
+			.context = visitor->context
+		});
+	}
+
+	frame_stack_free(&stack);
+}
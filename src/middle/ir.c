@@ -0,0 +1,120 @@
+#include "ir.h"
+
+#include "common/strslice.h"
+#include "frontend/error.h"
+#include "frontend/semantic/types.h"
+
+#include <assert.h>
+#include <inttypes.h>
+
+const char *ir_op_names[] = {
+	FOREACH_IR_OP(GENERATE_IR_STRS)
+};
+
+// Internal Functions //
+
+static void dump_constant(const ir_inst_t *inst, FILE *out) {
+	switch(inst->type) {
+		case TYPE_INT:
+			fprintf(out, " %" PRId64, (int64_t) inst->data.constant);
+			break;
+		case TYPE_BOOL:
+			fputs(inst->data.constant != 0 ? " true" : " false", out);
+			break;
+		case TYPE_NIL:
+			break;
+		default:
+			fprintf(out, " %" PRIu64, inst->data.constant);
+	}
+}
+
+static void dump_inst(const ir_t *ir, const ir_block_t *block, ir_ref_t ref, FILE *out) {
+	const ir_inst_t *inst = ir_get(ir, ref);
+	const char *name = ir_op_names[inst->op];
+	switch(inst->op) {
+		case IR_JUMP:
+			fprintf(out, "\t%s b%" PRIu32 "\n", name, block->succs[0]);
+			return;
+		case IR_BRANCH:
+			fprintf(out, "\t%s %%%" PRIu32 ", b%" PRIu32 ", b%" PRIu32 "\n",
+				name, inst->data.args[0], block->succs[0], block->succs[1]);
+			return;
+		case IR_RETURN:
+			fprintf(out, "\t%s %%%" PRIu32 "\n", name, inst->data.args[0]);
+			return;
+		default: ;
+	}
+
+	fprintf(out, "\t%%%" PRIu32 " = %s %s", ref, name, type_names[inst->type]);
+	switch(inst->op) {
+		case IR_CONST:
+			dump_constant(inst, out);
+			break;
+		case IR_CALL: ;
+			string_t callee = ast_node_content(ir->ast, inst->node);
+			fprintf(out, " %.*s(", (int) callee.size, callee.string);
+			for(uint32_t i=0; i<inst->data.list.count; i++)
+				fprintf(out, "%s%%%" PRIu32, i > 0 ? ", " : "",
+					ir->operands.data[inst->data.list.first + i]);
+			fputc(')', out);
+			break;
+		case IR_PHI:
+			for(uint32_t i=0; i<block->pred_count; i++)
+				fprintf(out, "%s [%%%" PRIu32 ", b%" PRIu32 "]", i > 0 ? "," : "",
+					inst->data.args[i], block->preds[i]);
+			break;
+		case IR_NEG:
+		case IR_NOT:
+			fprintf(out, " %%%" PRIu32, inst->data.args[0]);
+			break;
+		default:
+			fprintf(out, " %%%" PRIu32 ", %%%" PRIu32, inst->data.args[0], inst->data.args[1]);
+	}
+	fputc('\n', out);
+}
+
+// External Functions //
+
+void ir_init(ir_t *ir, const ast_t *ast) {
+	ir->ast = ast;
+	ir->arena = arena_new_raw(4096);
+	ir->insts = ir_inst_list_new(&ir->arena, 256);
+	ir->blocks = ir_block_list_new(&ir->arena, 32);
+	ir->operands = ir_ref_list_new(&ir->arena, 32);
+	// Take up the slot of `IR_NONE` so that no instruction can be referred by it
+	ir_add(ir, (ir_inst_t) {.op = IR_CONST, .type = TYPE_UNKNOWN, .node = AST_NONE});
+}
+
+void ir_free(ir_t *ir) {
+	arena_free(&ir->arena);
+	ir->insts = (ir_inst_list_t) {0};
+	ir->blocks = (ir_block_list_t) {0};
+	ir->operands = (ir_ref_list_t) {0};
+}
+
+ir_ref_t ir_add(ir_t *ir, ir_inst_t inst) {
+	// Every instruction comes from a node, of which there are fewer
+	assert(ir->insts.count < UINT32_MAX);
+	ir_inst_list_push(&ir->insts, inst);
+	return (ir_ref_t) (ir->insts.count - 1);
+}
+
+ir_label_t ir_add_block(ir_t *ir) {
+	assert(ir->blocks.count < IR_NO_BLOCK);
+	ir_block_list_push(&ir->blocks, (ir_block_t) {
+		.first = (uint32_t) ir->insts.count, .count = 0, .pred_count = 0,
+		.succs = {IR_NO_BLOCK, IR_NO_BLOCK}
+	});
+	return (ir_label_t) (ir->blocks.count - 1);
+}
+
+void ir_dump(const ir_t *ir, FILE *out) {
+	for(ir_label_t label = 0; label < ir->blocks.count; label++) {
+		const ir_block_t *block = ir_block(ir, label);
+		fprintf(out, "b%" PRIu32 ":", label);
+		for(uint32_t i=0; i<block->pred_count; i++)
+			fprintf(out, "%s b%" PRIu32, i > 0 ? "," : " ; preds", block->preds[i]);
+		fputc('\n', out);
+		for(uint32_t i=0; i<block->count; i++) dump_inst(ir, block, block->first + i, out);
+	}
+}
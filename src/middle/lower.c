@@ -0,0 +1,946 @@
+#include "lower.h"
+
+#include "common/arena.h"
+#include "common/vector.h"
+#include "frontend/error.h"
+#include "frontend/lexical/lexer.h"
+#include "frontend/semantic/types.h"
+#include "frontend/syntactic/visitor.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// A variable along with a value it had or was given.
+typedef struct def {
+	/// The `AST_VAR_SINGLE` node that declared the variable.
+	ast_ref_t var;
+	ir_ref_t value;
+} def_t;
+
+/** One of the two paths of the program that meet at a merge, as left by
+  * `end_path` until `merge` joins it with the other.
+  */
+typedef struct path {
+	/// The block the path ends in or `IR_NO_BLOCK` if it never gets there.
+	ir_label_t end;
+	/// What the path evaluates to.
+	ir_ref_t value;
+	/// The variables the path changed and their values at its end, a range
+	/// of the `changes` stack.
+	size_t first;
+	size_t count;
+} path_t;
+
+/// An operator of a chain that waits for the value of its right operand.
+typedef struct step {
+	ast_ref_t node;
+	/// The value the variable of a compound assignment had beforehand.
+	ir_ref_t before;
+} step_t;
+
+/// The variables of a loop, a range of `loop_vars`.
+typedef struct loop_range {
+	uint32_t first;
+	uint32_t count;
+} loop_range_t;
+
+/// How far the lowering of a node is, see `frame_t`.
+typedef enum stage {
+	/// Nothing of the node is lowered yet.
+	STAGE_START,
+	/// The left operand, the condition or the innermost operand of a chain
+	/// is lowered.
+	STAGE_LEFT,
+	/// The right operand or the body is lowered.
+	STAGE_RIGHT,
+	/// The other branches of an if are lowered.
+	STAGE_ELSE,
+	/// The child at `index` is lowered.
+	STAGE_CHILD,
+	/// The child the node comes down to is lowered.
+	STAGE_TAIL,
+	/// The branch of an if at `index` is about to be lowered.
+	STAGE_BRANCH
+} stage_t;
+
+/** A node being lowered. Each stage of a node either lowers a child, after
+  * which the node goes on from the next stage, or finishes the node. That
+  * way nodes wait for their children on a stack of the state rather than
+  * on the C stack, so there is no limit to how deep the tree can nest.
+  */
+typedef struct frame {
+	ast_ref_t node;
+	stage_t stage;
+	/// The child being lowered, or the branch of an if.
+	uint32_t index;
+	/// The child the node comes down to or the innermost operand of a chain.
+	ast_ref_t child;
+	/// The value of the left operand, or the last statement of a block.
+	ir_ref_t value;
+	/// The blocks the node ends up jumping to.
+	ir_label_t labels[3];
+	/// How far the trail, the chain or the arguments were when the node
+	/// started on them.
+	size_t base;
+	/// The path of a merge that was lowered first.
+	path_t path;
+	/// Whether an if is lowered for its value.
+	bool valued;
+} frame_t;
+
+VECTOR_DEFINE(def_list, def_t)
+VECTOR_DEFINE(step_list, step_t)
+VECTOR_DEFINE(label_list, ir_label_t)
+VECTOR_DEFINE(frame_list, frame_t)
+
+typedef struct lower_state {
+	ast_t *ast;
+	ir_t *ir;
+	arena_t arena;
+	/// The block being filled or `IR_NO_BLOCK` where code is unreachable.
+	ir_label_t block;
+	/// Every block that was filled, in the order they were.
+	label_list_t order;
+	/// The current value of every variable, indexed by its declaration.
+	ir_ref_t *values;
+	/// The values that variables had before each assignment, so that the
+	/// assignments of a path can be undone before lowering the other one.
+	def_list_t trail;
+	/// The changes of paths waiting to be merged, used as a stack.
+	def_list_t changes;
+	/// The variables declared before each loop and assigned in it, which
+	/// get a phi at its start.
+	ast_ref_list_t loop_vars;
+	/// Where the variables of each `AST_WHILE` are, indexed by the node. Made
+	/// along with `depths` once there is a loop, so code without any is spared.
+	loop_range_t *loops;
+	/// How many loops each variable is declared in within the outermost
+	/// loop around it, indexed by its node.
+	uint32_t *depths;
+	/// How many loops the node being lowered is in.
+	uint32_t loop_depth;
+	/// The operators of the chains being lowered, used as a stack.
+	step_list_t chain;
+	/// The arguments of the calls being lowered, used as a stack.
+	ir_ref_list_t args;
+	/// The nodes being lowered, used as a stack.
+	frame_list_t frames;
+	/// What the node that was finished last evaluates to.
+	ir_ref_t result;
+	/// Marks the nodes a search has come across, each search bumping the
+	/// generation so that the marks of the previous ones no longer count.
+	uint32_t *stamps;
+	uint32_t generation;
+} lower_state_t;
+
+// Internal Functions (Emitting) //
+
+static bool reachable(lower_state_t *ls) {
+	return ls->block != IR_NO_BLOCK;
+}
+
+static void begin(lower_state_t *ls, ir_label_t label) {
+	ls->block = label;
+	ir_block(ls->ir, label)->first = (uint32_t) ls->ir->insts.count;
+	label_list_push(&ls->order, label);
+}
+
+static ir_ref_t emit(lower_state_t *ls, ir_op_t op, type_id_t type, ast_ref_t node, ir_ref_t left, ir_ref_t right) {
+	// Unreachable code is left out altogether
+	if(!reachable(ls)) return IR_NONE;
+	ir_block(ls->ir, ls->block)->count++;
+	return ir_add(ls->ir, (ir_inst_t) {
+		.op = op, .type = type, .node = node, .data.args = {left, right}
+	});
+}
+
+static ir_ref_t emit_constant(lower_state_t *ls, type_id_t type, ast_ref_t node, uint64_t value) {
+	ir_ref_t ref = emit(ls, IR_CONST, type, node, IR_NONE, IR_NONE);
+	if(ref != IR_NONE) ir_get(ls->ir, ref)->data.constant = value;
+	return ref;
+}
+
+static void link(lower_state_t *ls, size_t slot, ir_label_t target) {
+	ir_block(ls->ir, ls->block)->succs[slot] = target;
+	ir_block_t *block = ir_block(ls->ir, target);
+	assert(block->pred_count < 2);
+	block->preds[block->pred_count++] = ls->block;
+}
+
+static void jump(lower_state_t *ls, ast_ref_t node, ir_label_t target) {
+	if(!reachable(ls)) return;
+	emit(ls, IR_JUMP, TYPE_NEVER, node, IR_NONE, IR_NONE);
+	link(ls, 0, target);
+	ls->block = IR_NO_BLOCK;
+}
+
+static void branch(lower_state_t *ls, ast_ref_t node, ir_ref_t condition, ir_label_t then, ir_label_t otherwise) {
+	if(!reachable(ls)) return;
+	emit(ls, IR_BRANCH, TYPE_NEVER, node, condition, IR_NONE);
+	link(ls, 0, then);
+	link(ls, 1, otherwise);
+	ls->block = IR_NO_BLOCK;
+}
+
+/// Makes up a `nil` for the nodes that evaluate to nothing.
+static ir_ref_t materialize(lower_state_t *ls, ir_ref_t value, ast_ref_t node) {
+	if(value != IR_NONE) return value;
+	return emit_constant(ls, TYPE_NIL, node, 0);
+}
+
+// Internal Functions (Variables) //
+
+static void assign(lower_state_t *ls, ast_ref_t var, ir_ref_t value) {
+	if(!reachable(ls)) return;
+	def_list_push(&ls->trail, (def_t) {.var = var, .value = ls->values[var]});
+	ls->values[var] = value;
+}
+
+static void undo(lower_state_t *ls, size_t mark) {
+	while(ls->trail.count > mark) {
+		def_t def = def_list_pop(&ls->trail);
+		ls->values[def.var] = def.value;
+	}
+}
+
+/** Ends one of the two paths of a merge with a jump to the merge block. The
+  * variables the path changed since `mark` are noted down along with their
+  * values and then restored, so that the other path starts off the same.
+  */
+static path_t end_path(lower_state_t *ls, size_t mark, ir_ref_t value, ast_ref_t node, ir_label_t target) {
+	path_t path = {.end = ls->block, .value = value, .first = ls->changes.count, .count = 0};
+	if(reachable(ls)) {
+		uint32_t generation = ++ls->generation;
+		for(size_t i=mark; i<ls->trail.count; i++) {
+			def_t *def = &ls->trail.data[i];
+			if(ls->stamps[def->var] == generation) continue;
+			ls->stamps[def->var] = generation;
+			// Variables declared on the path are gone once it ends
+			if(def->value == IR_NONE) continue;
+			def_list_push(&ls->changes, (def_t) {.var = def->var, .value = ls->values[def->var]});
+		}
+		path.count = ls->changes.count - path.first;
+		jump(ls, node, target);
+	}
+	undo(ls, mark);
+	return path;
+}
+
+static ir_ref_t join(lower_state_t *ls, type_id_t type, ast_ref_t node, ir_ref_t a, ir_ref_t b) {
+	if(a == b) return a;
+	return emit(ls, IR_PHI, type, node, a, b);
+}
+
+/** Starts the block the two paths meet at, unless neither gets there. The
+  * variables changed on either path get the value they have at the end of
+  * each, joined by a phi when those differ. Expects the variables to be as
+  * they were before either path, as `end_path` leaves them.
+  * @return The value the paths evaluate to, joined in the same way.
+  */
+static ir_ref_t merge(lower_state_t *ls, const path_t *a, const path_t *b, ir_label_t target, type_id_t type, ast_ref_t node) {
+	bool a_reached = a->end != IR_NO_BLOCK, b_reached = b->end != IR_NO_BLOCK;
+	ir_ref_t value = IR_NONE;
+	if(a_reached || b_reached) begin(ls, target);
+
+	if(a_reached && b_reached) {
+		// Put the values of the second path in place, keeping the ones they
+		// replace in the change list to restore them afterwards
+		def_t *changes = ls->changes.data;
+		for(size_t i=b->first; i<b->first + b->count; i++) {
+			ir_ref_t before = ls->values[changes[i].var];
+			ls->values[changes[i].var] = changes[i].value;
+			changes[i].value = before;
+		}
+
+		// The phis have to come first in the block, their results are held
+		// on the change stack until the values are restored
+		size_t results = ls->changes.count;
+		uint32_t generation = ++ls->generation;
+		for(size_t i=a->first; i<a->first + a->count; i++) {
+			ast_ref_t var = ls->changes.data[i].var;
+			ls->stamps[var] = generation;
+			ir_ref_t joined = join(ls, ls->ast->types[var], var, ls->changes.data[i].value, ls->values[var]);
+			def_list_push(&ls->changes, (def_t) {.var = var, .value = joined});
+		}
+		for(size_t i=b->first; i<b->first + b->count; i++) {
+			ast_ref_t var = ls->changes.data[i].var;
+			if(ls->stamps[var] == generation) continue;
+			ir_ref_t joined = join(ls, ls->ast->types[var], var, ls->changes.data[i].value, ls->values[var]);
+			def_list_push(&ls->changes, (def_t) {.var = var, .value = joined});
+		}
+		value = join(ls, type, node, a->value, b->value);
+
+		for(size_t i=b->first; i<b->first + b->count; i++)
+			ls->values[ls->changes.data[i].var] = ls->changes.data[i].value;
+		for(size_t i=results; i<ls->changes.count; i++)
+			assign(ls, ls->changes.data[i].var, ls->changes.data[i].value);
+	} else if(a_reached || b_reached) {
+		const path_t *path = a_reached ? a : b;
+		for(size_t i=path->first; i<path->first + path->count; i++)
+			assign(ls, ls->changes.data[i].var, ls->changes.data[i].value);
+		value = path->value;
+	}
+
+	ls->changes.count = a->first;
+	return value;
+}
+
+/// The state of `find_loop_vars` as it goes through the tree.
+typedef struct loop_scan {
+	lower_state_t *ls;
+	/// The variables of the loops the walk is in, those of each loop
+	/// starting where its range in `loops` does until it is done.
+	ast_ref_list_t found;
+	/// How many loops the walk is in.
+	uint32_t depth;
+} loop_scan_t;
+
+static bool note_declared(const ast_visit_t *visit) {
+	loop_scan_t *scan = (loop_scan_t *) visit->context;
+	scan->ls->depths[visit->node] = scan->depth;
+	return true;
+}
+
+static bool note_assigned(const ast_visit_t *visit) {
+	loop_scan_t *scan = (loop_scan_t *) visit->context;
+	ast_node_t *node = ast_get(visit->tree, visit->node);
+	token_type_t operator = (token_type_t) visit->tree->tokens->types[node->token];
+	if(operator != TOK_OP_ASSIGN && operator != TOK_OP_ASSIGN_ALT) return true;
+
+	// Variables declared in the loop start over on every iteration
+	ast_ref_t var = visit->tree->decls[node->children.pair.left];
+	if(scan->ls->depths[var] < scan->depth) ast_ref_list_push(&scan->found, var);
+	return true;
+}
+
+static bool enter_loop(const ast_visit_t *visit) {
+	loop_scan_t *scan = (loop_scan_t *) visit->context;
+	scan->ls->loops[visit->node].first = (uint32_t) scan->found.count;
+	scan->depth++;
+	return true;
+}
+
+/** Keeps the variables found in a loop, each once and in the order they are
+  * first assigned in, and leaves the ones declared before the loop around it
+  * too for that loop, so that no loop is gone through more than once.
+  */
+static void leave_loop(const ast_visit_t *visit) {
+	loop_scan_t *scan = (loop_scan_t *) visit->context;
+	lower_state_t *ls = scan->ls;
+	loop_range_t *range = &ls->loops[visit->node];
+	size_t start = range->first, kept = start;
+	uint32_t generation = ++ls->generation;
+	range->first = (uint32_t) ls->loop_vars.count;
+	scan->depth--;
+	for(size_t i=start; i<scan->found.count; i++) {
+		ast_ref_t var = scan->found.data[i];
+		if(ls->stamps[var] == generation) continue;
+		ls->stamps[var] = generation;
+		ast_ref_list_push(&ls->loop_vars, var);
+		if(ls->depths[var] < scan->depth) scan->found.data[kept++] = var;
+	}
+	range->count = (uint32_t) (ls->loop_vars.count - range->first);
+	scan->found.count = kept;
+}
+
+/** Finds the variables of an outermost loop and of every loop in it, see
+  * `loop_vars`, so that no node is gone through more than once and the code
+  * outside of loops not at all. The variables declared outside of the loop
+  * are left at a depth of 0, those of earlier loops being out of scope.
+  */
+static void find_loop_vars(lower_state_t *ls, ast_ref_t loop) {
+	if(ls->loops == NULL) {
+		ls->loops = (loop_range_t *) calloc(ls->ast->nodes.count, sizeof(loop_range_t));
+		ls->depths = (uint32_t *) calloc(ls->ast->nodes.count, sizeof(uint32_t));
+		error_if(ls->loops == NULL || ls->depths == NULL);
+	}
+	loop_scan_t scan = {.ls = ls, .depth = 0, .found = ast_ref_list_new(NULL, 16)};
+	ast_visitor_t visitor = {
+		.pre[AST_VAR_SINGLE] = note_declared,
+		.pre[AST_OP_BINARY] = note_assigned,
+		.pre[AST_WHILE] = enter_loop,
+		.post[AST_WHILE] = leave_loop,
+		.context = &scan
+	};
+	ast_walk(ls->ast, loop, &visitor);
+	ast_ref_list_free(&scan.found);
+}
+
+/// Gives a node a frame to be lowered from the start.
+static frame_t *push_frame(lower_state_t *ls, ast_ref_t node) {
+	// Filling in the node afterwards is a lot faster than pushing a frame
+	// made with it, which gets copied in pieces that straddle the ones it
+	// was written in and so have to wait for them
+	frame_list_push(&ls->frames, (frame_t) {.stage = STAGE_START});
+	frame_t *frame = frame_list_peek(&ls->frames);
+	frame->node = node;
+	return frame;
+}
+
+// Internal Functions (Node Types) //
+
+static ir_op_t arithmetic_op(char operator, type_id_t type) {
+	bool is_unsigned = type == TYPE_NAT;
+	switch(operator) {
+		case '+': return IR_ADD;
+		case '-': return IR_SUB;
+		case '*': return IR_MUL;
+		case '/': return is_unsigned ? IR_UDIV : IR_DIV;
+		default: return is_unsigned ? IR_UMOD : IR_MOD;
+	}
+}
+
+static token_type_t token_type(lower_state_t *ls, ast_ref_t ref) {
+	return (token_type_t) ls->ast->tokens->types[ast_get(ls->ast, ref)->token];
+}
+
+/// Whether a node is a prefix operator or an assignment that is not folded.
+static bool is_chained(lower_state_t *ls, ast_ref_t ref) {
+	ast_node_type_t type = ast_get(ls->ast, ref)->type;
+	if(ls->ast->folded[ref]) return false;
+	if(type == AST_OP_UNARY) return true;
+	return type == AST_OP_BINARY &&
+		(token_type(ls, ref) == TOK_OP_ASSIGN || token_type(ls, ref) == TOK_OP_ASSIGN_ALT);
+}
+
+static ir_ref_t lower_step(lower_state_t *ls, step_t step, ir_ref_t operand) {
+	ast_node_t *node = ast_get(ls->ast, step.node);
+	type_id_t type = ls->ast->types[step.node];
+	// Only assignments have a variable on their left
+	ast_ref_t var = ls->ast->decls[node->children.pair.left];
+	ir_ref_t result;
+	switch(token_type(ls, step.node)) {
+		case TOK_KW_NOT:
+			return emit(ls, IR_NOT, type, step.node, operand, IR_NONE);
+		case TOK_OP_MINUS:
+			return emit(ls, IR_NEG, type, step.node, operand, IR_NONE);
+		case TOK_OP_ASSIGN:
+			assign(ls, var, operand);
+			return operand;
+		case TOK_OP_ASSIGN_ALT: ;
+			string_t content = ast_node_content(ls->ast, step.node);
+			result = emit(ls, arithmetic_op(content.string[0], type), type, step.node, step.before, operand);
+			assign(ls, var, result);
+			return result;
+		default:
+			return operand;
+	}
+}
+
+/** Lowers a child of the node being lowered, after which the node goes on
+  * with what the child evaluates to in `result`. The leaves of the tree are
+  * done right away, any other child gets a frame to be lowered next. That
+  * may move the frame of the node, which is looked up again once the child
+  * is done.
+  * @return Whether the child got a frame, which the node has to wait for.
+  */
+static bool descend(lower_state_t *ls, ast_ref_t child) {
+	// Folded nodes, literals among them, have no effects to keep and nil is
+	// made up where needed
+	if(!reachable(ls) || child == AST_NONE) ls->result = IR_NONE;
+	else if(ls->ast->folded[child]) {
+		type_id_t type = ls->ast->types[child];
+		ls->result = type == TYPE_NIL ? IR_NONE : emit_constant(ls, type, child, ls->ast->values[child]);
+	} else if(ast_get(ls->ast, child)->type == AST_IDENT)
+		ls->result = ls->values[ls->ast->decls[child]];
+	else {
+		push_frame(ls, child);
+		return true;
+	}
+	return false;
+}
+
+/// Finishes the node being lowered, leaving what it evaluates to in `result`.
+static void finish(lower_state_t *ls, ir_ref_t value) {
+	frame_list_pop(&ls->frames);
+	ls->result = value;
+}
+
+/** Lowers a run of prefix operators and assignments, each the right operand
+  * of the one before, like `x = y = -z`. The operators are noted down on the
+  * way to the innermost operand and lowered on the way back in a loop, so
+  * that long runs do not take a frame each.
+  */
+static void lower_chain(lower_state_t *ls, frame_t *frame) {
+	if(frame->stage == STAGE_START) {
+		frame->base = ls->chain.count;
+		ast_ref_t ref = frame->node;
+		for(; is_chained(ls, ref); ref = ast_get(ls->ast, ref)->children.pair.right) {
+			step_t step = {.node = ref, .before = IR_NONE};
+			// A compound assignment reads its variable before its right side runs
+			if(token_type(ls, ref) == TOK_OP_ASSIGN_ALT)
+				step.before = ls->values[ls->ast->decls[ast_get(ls->ast, ref)->children.pair.left]];
+			step_list_push(&ls->chain, step);
+		}
+		frame->child = ref;
+		frame->stage = STAGE_LEFT;
+		if(descend(ls, ref)) return;
+	}
+	ir_ref_t value = materialize(ls, ls->result, frame->child);
+	while(ls->chain.count > frame->base) value = lower_step(ls, step_list_pop(&ls->chain), value);
+	finish(ls, value);
+}
+
+static ir_ref_t lower_compare(lower_state_t *ls, ast_ref_t ref, ir_ref_t left_value, ir_ref_t right_value) {
+	ast_node_t *node = ast_get(ls->ast, ref);
+	ast_ref_t left = node->children.pair.left, right = node->children.pair.right;
+	string_t operator = ast_node_content(ls->ast, ref);
+	bool is_unsigned = ls->ast->types[left] == TYPE_NAT && ls->ast->types[right] == TYPE_NAT;
+
+	type_id_t type = ls->ast->types[ref];
+	bool or_equal = operator.size == 2 && operator.string[1] == '=';
+	switch(operator.string[0]) {
+		case '=':
+			return emit(ls, IR_EQ, type, ref, left_value, right_value);
+		case '<':
+			if(operator.size == 2 && operator.string[1] == '>')
+				return emit(ls, IR_NE, type, ref, left_value, right_value);
+			return emit(ls, or_equal ? (is_unsigned ? IR_ULE : IR_LE) : (is_unsigned ? IR_ULT : IR_LT),
+				type, ref, left_value, right_value);
+		default:
+			// Greater is less with the operands the other way around
+			return emit(ls, or_equal ? (is_unsigned ? IR_ULE : IR_LE) : (is_unsigned ? IR_ULT : IR_LT),
+				type, ref, right_value, left_value);
+	}
+}
+
+/// Lowers the binary operators that evaluate both of their operands.
+static void lower_operands(lower_state_t *ls, frame_t *frame) {
+	ast_ref_t ref = frame->node;
+	ast_node_t *node = ast_get(ls->ast, ref);
+	ast_ref_t left = node->children.pair.left, right = node->children.pair.right;
+	if(frame->stage == STAGE_START) {
+		frame->stage = STAGE_LEFT;
+		if(descend(ls, left)) return;
+	}
+	if(frame->stage == STAGE_LEFT) {
+		frame->value = materialize(ls, ls->result, left);
+		frame->stage = STAGE_RIGHT;
+		if(descend(ls, right)) return;
+	}
+
+	ir_ref_t right_value = materialize(ls, ls->result, right);
+	type_id_t type = ls->ast->types[ref];
+	if(token_type(ls, ref) == TOK_OP_COMPARE) finish(ls, lower_compare(ls, ref, frame->value, right_value));
+	else {
+		string_t content = ast_node_content(ls->ast, ref);
+		finish(ls, emit(ls, arithmetic_op(content.string[0], type), type, ref, frame->value, right_value));
+	}
+}
+
+/// Lowers `and` and `or`, which skip their right side when the left decides.
+static void lower_logic(lower_state_t *ls, frame_t *frame, bool is_and) {
+	ast_ref_t ref = frame->node;
+	ast_node_t *node = ast_get(ls->ast, ref);
+	ast_ref_t left = node->children.pair.left, right = node->children.pair.right;
+	if(frame->stage == STAGE_START) {
+		// A known left side either decides, in which case the right side is
+		// never run, or leaves it up to the right side
+		if(ls->ast->folded[left]) {
+			bool decides = (ls->ast->values[left] != 0) != is_and;
+			frame->child = decides ? left : right;
+			frame->stage = STAGE_TAIL;
+		} else frame->child = left, frame->stage = STAGE_LEFT;
+		if(descend(ls, frame->child)) return;
+	}
+	if(frame->stage == STAGE_TAIL) {
+		finish(ls, materialize(ls, ls->result, frame->child));
+		return;
+	}
+	if(frame->stage == STAGE_LEFT) {
+		ir_ref_t left_value = materialize(ls, ls->result, left);
+		if(!reachable(ls)) {
+			finish(ls, IR_NONE);
+			return;
+		}
+		ir_label_t rest = ir_add_block(ls->ir), after = ir_add_block(ls->ir);
+		// The left side is the result when the right one is skipped
+		frame->path = (path_t) {.end = ls->block, .value = left_value, .first = ls->changes.count, .count = 0};
+		if(is_and) branch(ls, ref, left_value, rest, after);
+		else branch(ls, ref, left_value, after, rest);
+
+		frame->base = ls->trail.count;
+		frame->labels[0] = after;
+		begin(ls, rest);
+		frame->stage = STAGE_RIGHT;
+		if(descend(ls, right)) return;
+	}
+
+	ir_ref_t right_value = materialize(ls, ls->result, right);
+	path_t taken = end_path(ls, frame->base, right_value, ref, frame->labels[0]);
+	finish(ls, merge(ls, &frame->path, &taken, frame->labels[0], ls->ast->types[ref], ref));
+}
+
+static void lower_binary(lower_state_t *ls, frame_t *frame) {
+	token_type_t operator = token_type(ls, frame->node);
+	switch(operator) {
+		case TOK_KW_AND:
+		case TOK_KW_OR:
+			lower_logic(ls, frame, operator == TOK_KW_AND);
+			return;
+		case TOK_OP_ASSIGN:
+		case TOK_OP_ASSIGN_ALT:
+			lower_chain(ls, frame);
+			return;
+		default:
+			lower_operands(ls, frame);
+	}
+}
+
+static void lower_call(lower_state_t *ls, frame_t *frame) {
+	ast_ref_t ref = frame->node;
+	size_t count = ast_child_count(ls->ast, ref);
+	// A child that got a frame is done by the time the node is back to it
+	bool resumed = frame->stage == STAGE_CHILD;
+	if(!resumed) frame->base = ls->args.count, frame->stage = STAGE_CHILD;
+	for(; frame->index < count; frame->index++, resumed = false) {
+		ast_ref_t arg = ast_child(ls->ast, ref, frame->index);
+		if(!resumed && descend(ls, arg)) return;
+		ir_ref_list_push(&ls->args, materialize(ls, ls->result, arg));
+	}
+
+	size_t base = frame->base;
+	ir_ref_t call = emit(ls, IR_CALL, ls->ast->types[ref], ref, IR_NONE, IR_NONE);
+	if(call != IR_NONE) {
+		// Arguments that are calls themselves are done by now, so the list
+		// of each call is contiguous
+		uint32_t first = (uint32_t) ls->ir->operands.count;
+		for(size_t i=base; i<ls->args.count; i++) ir_ref_list_push(&ls->ir->operands, ls->args.data[i]);
+		ir_get(ls->ir, call)->data.list.first = first;
+		ir_get(ls->ir, call)->data.list.count = (uint32_t) (ls->args.count - base);
+	}
+	ls->args.count = base;
+	finish(ls, call);
+}
+
+static void lower_return(lower_state_t *ls, frame_t *frame) {
+	ast_ref_t ref = frame->node, operand = ast_get(ls->ast, ref)->children.pair.left;
+	if(frame->stage == STAGE_START) {
+		frame->stage = STAGE_LEFT;
+		if(descend(ls, operand)) return;
+	}
+	emit(ls, IR_RETURN, TYPE_NEVER, ref, materialize(ls, ls->result, operand), IR_NONE);
+	ls->block = IR_NO_BLOCK;
+	finish(ls, IR_NONE);
+}
+
+/// Lowers the statements of a block, which evaluates to the last of them.
+static void lower_block(lower_state_t *ls, frame_t *frame) {
+	ast_ref_t ref = frame->node;
+	size_t count = ast_child_count(ls->ast, ref);
+	bool resumed = frame->stage == STAGE_CHILD;
+	if(!resumed) frame->value = IR_NONE, frame->stage = STAGE_CHILD;
+	for(; frame->index < count; frame->index++, resumed = false) {
+		if(!resumed && descend(ls, ast_child(ls->ast, ref, frame->index))) return;
+		frame->value = ls->result;
+	}
+	finish(ls, frame->value);
+}
+
+static void lower_vars(lower_state_t *ls, frame_t *frame) {
+	ast_ref_t ref = frame->node;
+	size_t count = ast_child_count(ls->ast, ref);
+	bool resumed = frame->stage == STAGE_CHILD;
+	frame->stage = STAGE_CHILD;
+	for(; frame->index < count; frame->index++, resumed = false) {
+		ast_ref_t var = ast_child(ls->ast, ref, frame->index);
+		// Every use of a folded variable is folded into its value
+		if(ls->ast->folded[var]) continue;
+		ast_ref_t value = ast_get(ls->ast, var)->children.pair.right;
+		if(!resumed && descend(ls, value)) return;
+		assign(ls, var, materialize(ls, ls->result, value));
+	}
+	finish(ls, IR_NONE);
+}
+
+/** Lowers the branch of an if at `index` of the frame, the other branches
+  * being lowered as an if nested in its else branch, which has a frame of its
+  * own that starts at `STAGE_BRANCH`.
+  */
+static void lower_if(lower_state_t *ls, frame_t *frame) {
+	ast_ref_t list = frame->node;
+	size_t count = ast_child_count(ls->ast, list);
+	if(frame->stage == STAGE_START) {
+		type_id_t type = ls->ast->types[list];
+		frame->valued = type != TYPE_NIL && type != TYPE_NEVER;
+		frame->stage = STAGE_BRANCH;
+	}
+	ast_ref_t single = ast_child(ls->ast, list, frame->index);
+	ast_ref_t condition = ast_get(ls->ast, single)->children.pair.left;
+	if(frame->stage == STAGE_BRANCH) {
+		// A branch known not to be taken is left out
+		while(condition != AST_NONE && ls->ast->folded[condition] && ls->ast->values[condition] == 0) {
+			if(frame->index + 1 == count) {
+				finish(ls, IR_NONE);
+				return;
+			}
+			single = ast_child(ls->ast, list, ++frame->index);
+			condition = ast_get(ls->ast, single)->children.pair.left;
+		}
+		// The else branch, or a branch known to be taken
+		bool taken = condition == AST_NONE || ls->ast->folded[condition];
+		frame->stage = taken ? STAGE_TAIL : STAGE_LEFT;
+		if(descend(ls, taken ? ast_get(ls->ast, single)->children.pair.right : condition)) return;
+	}
+	if(frame->stage == STAGE_TAIL) {
+		finish(ls, ls->result);
+		return;
+	}
+
+	ast_ref_t body = ast_get(ls->ast, single)->children.pair.right;
+	if(frame->stage == STAGE_LEFT) {
+		ir_ref_t condition_value = materialize(ls, ls->result, condition);
+		if(!reachable(ls)) {
+			finish(ls, IR_NONE);
+			return;
+		}
+		ir_label_t then = ir_add_block(ls->ir), otherwise = ir_add_block(ls->ir), after = ir_add_block(ls->ir);
+		branch(ls, single, condition_value, then, otherwise);
+		frame->base = ls->trail.count;
+		frame->labels[0] = otherwise, frame->labels[1] = after;
+		begin(ls, then);
+		frame->stage = STAGE_RIGHT;
+		if(descend(ls, body)) return;
+	}
+	if(frame->stage == STAGE_RIGHT) {
+		ir_ref_t value = frame->valued ? materialize(ls, ls->result, body) : IR_NONE;
+		frame->path = end_path(ls, frame->base, value, single, frame->labels[1]);
+		begin(ls, frame->labels[0]);
+		frame->stage = STAGE_ELSE;
+		if(frame->index + 1 < count) {
+			uint32_t next = frame->index + 1;
+			bool valued = frame->valued;
+			frame_t *rest = push_frame(ls, list);
+			rest->stage = STAGE_BRANCH;
+			rest->index = next, rest->valued = valued;
+			return;
+		}
+		ls->result = IR_NONE;
+	}
+
+	ir_ref_t value = frame->valued ? materialize(ls, ls->result, list) : IR_NONE;
+	path_t skipped = end_path(ls, frame->base, value, single, frame->labels[1]);
+	finish(ls, merge(ls, &frame->path, &skipped, frame->labels[1], ls->ast->types[list], list));
+}
+
+static void lower_while(lower_state_t *ls, frame_t *frame) {
+	ast_ref_t ref = frame->node;
+	ast_ref_t condition = ast_get(ls->ast, ref)->children.pair.left;
+	ast_ref_t body = ast_get(ls->ast, ref)->children.pair.right;
+	// A loop known to never run is left out, one known to run forever goes
+	// straight into its body and is never left
+	bool forever = ls->ast->folded[condition];
+	if(frame->stage == STAGE_START) {
+		if(forever && ls->ast->values[condition] == 0) {
+			finish(ls, IR_NONE);
+			return;
+		}
+		if(ls->loop_depth++ == 0) find_loop_vars(ls, ref);
+		loop_range_t vars = ls->loops[ref];
+		ir_label_t header = ir_add_block(ls->ir);
+		ir_label_t inside = forever ? header : ir_add_block(ls->ir);
+		ir_label_t after = forever ? IR_NO_BLOCK : ir_add_block(ls->ir);
+		jump(ls, ref, header);
+		begin(ls, header);
+		// The second value of each phi is only known once the body is lowered
+		for(size_t i=vars.first; i<vars.first + vars.count; i++) {
+			ast_ref_t var = ls->loop_vars.data[i];
+			assign(ls, var, emit(ls, IR_PHI, ls->ast->types[var], var, ls->values[var], IR_NONE));
+		}
+		frame->labels[0] = header, frame->labels[1] = inside, frame->labels[2] = after;
+		frame->stage = STAGE_LEFT;
+		if(!forever && descend(ls, condition)) return;
+	}
+	if(frame->stage == STAGE_LEFT) {
+		ir_ref_t condition_value = forever ? IR_NONE : materialize(ls, ls->result, condition);
+		if(!reachable(ls)) {
+			ls->loop_depth--;
+			finish(ls, IR_NONE);
+			return;
+		}
+		frame->base = ls->trail.count;
+		if(!forever) {
+			branch(ls, ref, condition_value, frame->labels[1], frame->labels[2]);
+			begin(ls, frame->labels[1]);
+		}
+		frame->stage = STAGE_RIGHT;
+		if(descend(ls, body)) return;
+	}
+
+	loop_range_t vars = ls->loops[ref];
+	if(reachable(ls)) {
+		jump(ls, ref, frame->labels[0]);
+		uint32_t phis = ir_block(ls->ir, frame->labels[0])->first;
+		for(size_t i=0; i<vars.count; i++)
+			ir_get(ls->ir, phis + i)->data.args[1] = ls->values[ls->loop_vars.data[vars.first + i]];
+	}
+	undo(ls, frame->base);
+	if(!forever) begin(ls, frame->labels[2]);
+	ls->loop_depth--;
+	finish(ls, IR_NONE);
+}
+
+/// Lowers the tree under a node, going through the frames of its nodes
+/// until all of them are finished.
+static ir_ref_t lower(lower_state_t *ls, ast_ref_t root) {
+	size_t base = ls->frames.count;
+	descend(ls, root);
+	while(ls->frames.count > base) {
+		frame_t *frame = frame_list_peek(&ls->frames);
+		switch(ast_get(ls->ast, frame->node)->type) {
+			case AST_OP_UNARY: lower_chain(ls, frame); break;
+			case AST_OP_BINARY: lower_binary(ls, frame); break;
+			case AST_CALL: lower_call(ls, frame); break;
+			case AST_RETURN: lower_return(ls, frame); break;
+			case AST_BLOCK: lower_block(ls, frame); break;
+			case AST_VAR_LIST: lower_vars(ls, frame); break;
+			case AST_WHILE: lower_while(ls, frame); break;
+			case AST_IF_LIST: lower_if(ls, frame); break;
+			default: finish(ls, IR_NONE);
+		}
+	}
+	return ls->result;
+}
+
+// Internal Functions (Cleanup) //
+
+static ir_ref_t resolve(ir_ref_t *forward, ir_ref_t ref) {
+	while(forward[ref] != IR_NONE) ref = forward[ref];
+	return ref;
+}
+
+/** Forwards every phi that only ever selects a single value, other than
+  * itself, to that value. Removing a phi can leave others selecting a single
+  * value, so this goes on until there are none left.
+  */
+static void forward_phis(lower_state_t *ls, ir_ref_t *forward) {
+	for(bool changed = true; changed; ) {
+		changed = false;
+		for(size_t i=0; i<ls->order.count; i++) {
+			ir_block_t *block = ir_block(ls->ir, ls->order.data[i]);
+			for(ir_ref_t ref = block->first; ref < block->first + block->count; ref++) {
+				ir_inst_t *phi = ir_get(ls->ir, ref);
+				if(phi->op != IR_PHI) break;
+				if(forward[ref] != IR_NONE) continue;
+
+				ir_ref_t same = IR_NONE;
+				bool trivial = true;
+				for(uint32_t j=0; j<block->pred_count && trivial; j++) {
+					ir_ref_t value = resolve(forward, phi->data.args[j]);
+					if(value == ref || value == same) continue;
+					if(same != IR_NONE) trivial = false;
+					same = value;
+				}
+				if(!trivial || same == IR_NONE) continue;
+				forward[ref] = same;
+				changed = true;
+			}
+		}
+	}
+}
+
+/** Drops the forwarded phis and the blocks that were never filled, moving
+  * the instructions down over them and numbering the blocks in the order
+  * they were filled, which is the order their instructions are laid out in.
+  */
+static void compact(lower_state_t *ls, ir_ref_t *forward) {
+	ir_t *ir = ls->ir;
+	ir_ref_t *renumbered = (ir_ref_t *) calloc(ir->insts.count, sizeof(ir_ref_t));
+	ir_label_t *relabeled = (ir_label_t *) calloc(ir->blocks.count, sizeof(ir_label_t));
+	ir_block_t *blocks = (ir_block_t *) malloc(ls->order.count * sizeof(ir_block_t));
+	error_if(renumbered == NULL || relabeled == NULL || blocks == NULL);
+
+	ir_ref_t next = 1, position = 1;
+	for(size_t i=0; i<ls->order.count; i++) {
+		relabeled[ls->order.data[i]] = (ir_label_t) i;
+		blocks[i] = *ir_block(ir, ls->order.data[i]);
+	}
+	for(ir_ref_t ref = 1; ref < ir->insts.count; ref++)
+		if(forward[ref] == IR_NONE) renumbered[ref] = next++;
+
+	#define REMAP(m_ref) m_ref = renumbered[resolve(forward, m_ref)]
+	for(size_t i=0; i<ls->order.count; i++) {
+		ir_block_t *block = &blocks[i];
+		uint32_t first = position;
+		for(ir_ref_t ref = block->first; ref < block->first + block->count; ref++) {
+			if(forward[ref] != IR_NONE) continue;
+			ir_inst_t inst = *ir_get(ir, ref);
+			switch(inst.op) {
+				case IR_CONST:
+				case IR_JUMP:
+					break;
+				case IR_CALL:
+					for(uint32_t j=0; j<inst.data.list.count; j++)
+						REMAP(ir->operands.data[inst.data.list.first + j]);
+					break;
+				case IR_PHI:
+					for(uint32_t j=0; j<block->pred_count; j++) REMAP(inst.data.args[j]);
+					break;
+				case IR_NEG:
+				case IR_NOT:
+				case IR_BRANCH:
+				case IR_RETURN:
+					REMAP(inst.data.args[0]);
+					break;
+				default:
+					REMAP(inst.data.args[0]);
+					REMAP(inst.data.args[1]);
+			}
+			// Instructions only ever move down, over the ones dropped
+			*ir_get(ir, position++) = inst;
+		}
+		block->first = first, block->count = position - first;
+		for(uint32_t j=0; j<block->pred_count; j++) block->preds[j] = relabeled[block->preds[j]];
+		for(size_t j=0; j<2; j++) if(block->succs[j] != IR_NO_BLOCK) block->succs[j] = relabeled[block->succs[j]];
+	}
+	#undef REMAP
+
+	ir->insts.count = next;
+	ir->blocks.count = ls->order.count;
+	for(size_t i=0; i<ls->order.count; i++) ir->blocks.data[i] = blocks[i];
+	free(renumbered);
+	free(relabeled);
+	free(blocks);
+}
+
+// External Functions //
+
+void lower_run(ast_t *ast, ir_t *ir) {
+	assert(ast->decls != NULL && ast->types != NULL && ast->folded != NULL);
+	lower_state_t ls = {
+		.ast = ast, .ir = ir,
+		.block = IR_NO_BLOCK, .loops = NULL, .depths = NULL,
+		.loop_depth = 0, .generation = 0
+	};
+	ls.arena = arena_new(4096);
+	ls.order = label_list_new(&ls.arena, 32);
+	ls.trail = def_list_new(&ls.arena, 64);
+	ls.changes = def_list_new(&ls.arena, 64);
+	ls.loop_vars = ast_ref_list_new(&ls.arena, 16);
+	ls.chain = step_list_new(&ls.arena, 16);
+	ls.args = ir_ref_list_new(&ls.arena, 16);
+	ls.frames = frame_list_new(NULL, 64);
+	ls.values = (ir_ref_t *) calloc(ast->nodes.count, sizeof(ir_ref_t));
+	ls.stamps = (uint32_t *) calloc(ast->nodes.count, sizeof(uint32_t));
+	error_if(ls.values == NULL || ls.stamps == NULL);
+
+	begin(&ls, ir_add_block(ir));
+	lower(&ls, ast->root);
+	// Falling off the end of the program is returning nothing
+	emit(&ls, IR_RETURN, TYPE_NEVER, ast->root, materialize(&ls, IR_NONE, ast->root), IR_NONE);
+
+	ir_ref_t *forward = (ir_ref_t *) calloc(ir->insts.count, sizeof(ir_ref_t));
+	error_if(forward == NULL);
+	forward_phis(&ls, forward);
+	compact(&ls, forward);
+
+	free(forward);
+	free(ls.values);
+	free(ls.stamps);
+	free(ls.loops);
+	free(ls.depths);
+	frame_list_free(&ls.frames);
+	arena_free(&ls.arena);
+}
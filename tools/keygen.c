@@ -0,0 +1,130 @@
+// Generates the keyword lookup table of the lexer as a perfect hash over
+// the keywords in `FOREACH_KEYWORD`. Every identifier of up to eight
+// characters is read as a zero-extended 64-bit word which is hashed with a
+// multiply-shift. This tool searches for a multiplier that maps every
+// keyword to a distinct slot of the smallest table possible, so a lookup is
+// one multiplication and one word comparison against the occupant.
+// Usage: keygen <output file>
+
+#include "frontend/lexical/keywords.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_TABLE_BITS 8
+#define ATTEMPTS_PER_SIZE (1 << 20)
+
+#define GENERATE_KEYWORD(word, type) {#word, "TOK_" #type},
+static const struct keyword {
+	const char *word;
+	const char *type;
+} keywords[] = {
+	FOREACH_KEYWORD(GENERATE_KEYWORD)
+};
+#define KEYWORD_COUNT (sizeof(keywords) / sizeof(keywords[0]))
+#define WORD_OF(keyword) to_word((keyword).word, strlen((keyword).word))
+
+// The same conversion the lexer does, a copy that is padded with zeroes.
+static uint64_t to_word(const char *bytes, size_t length) {
+	char padded[sizeof(uint64_t)] = {0};
+	memcpy(padded, bytes, length);
+	uint64_t ret;
+	memcpy(&ret, padded, sizeof(uint64_t));
+	return ret;
+}
+
+// SplitMix64, seeded with a constant so that the output is reproducible.
+static uint64_t next_candidate(uint64_t *state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15u);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+	return (z ^ (z >> 31)) | 1;
+}
+
+static bool try_multiplier(uint64_t multiplier, unsigned bits, int *slots) {
+	size_t size = (size_t) 1 << bits;
+	for(size_t i=0; i<size; i++) slots[i] = -1;
+	for(size_t i=0; i<KEYWORD_COUNT; i++) {
+		size_t slot = (size_t) ((WORD_OF(keywords[i]) * multiplier) >> (64 - bits));
+		if(slots[slot] != -1) return false;
+		slots[slot] = (int) i;
+	}
+	return true;
+}
+
+static void emit(FILE *out, uint64_t multiplier, unsigned bits, const int *slots) {
+	size_t size = (size_t) 1 << bits;
+	fprintf(out, "// Generated by tools/keygen.c from FOREACH_KEYWORD, do not edit.\n\n");
+	fprintf(out, "#include \"frontend/lexical/keywords.h\"\n\n");
+	fprintf(out, "#include <stdint.h>\n\n");
+	fprintf(out, "#define KEYWORD_HASH(word) ((size_t) (((word) * UINT64_C(0x%016" PRIX64 ")) >> %u))\n\n", multiplier, 64 - bits);
+
+	fprintf(out, "// Keeps the first N characters of a word read from the source.\n");
+	fprintf(out, "static const uint64_t keyword_masks[KEYWORD_MAX_LENGTH + 1] = {\n");
+	for(unsigned length = 0; length <= KEYWORD_MAX_LENGTH; length++) {
+		char ones[KEYWORD_MAX_LENGTH];
+		memset(ones, 0xFF, length);
+		uint64_t mask = to_word(ones, length);
+		fprintf(out, "\tUINT64_C(0x%016" PRIX64 "),\n", mask);
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "// The keyword occupying each slot as a word, zero if unoccupied.\n");
+	fprintf(out, "static const uint64_t keyword_words[%zu] = {\n", size);
+	for(size_t i=0; i<size; i++) {
+		uint64_t word = slots[i] == -1 ? 0 : WORD_OF(keywords[slots[i]]);
+		fprintf(out, "\tUINT64_C(0x%016" PRIX64 "),", word);
+		if(slots[i] != -1) fprintf(out, " // %s", keywords[slots[i]].word);
+		fprintf(out, "\n");
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "static const uint8_t keyword_types[%zu] = {\n", size);
+	for(size_t i=0; i<size; i++)
+		fprintf(out, "\t%s,\n", slots[i] == -1 ? "TOK_IDENT" : keywords[slots[i]].type);
+	fprintf(out, "};\n");
+}
+
+int main(int argc, char **argv) {
+	if(argc != 2) {
+		fprintf(stderr, "Usage: %s <output file>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for(size_t i=0; i<KEYWORD_COUNT; i++) {
+		if(strlen(keywords[i].word) > KEYWORD_MAX_LENGTH) {
+			fprintf(stderr, "Keyword \"%s\" is longer than %d characters\n",
+				keywords[i].word, KEYWORD_MAX_LENGTH);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// start from the smallest table that can fit all keywords
+	unsigned bits = 0;
+	while(((size_t) 1 << bits) < KEYWORD_COUNT) bits++;
+
+	int slots[1 << MAX_TABLE_BITS];
+	for(; bits <= MAX_TABLE_BITS; bits++) {
+		uint64_t state = 0;
+		for(unsigned attempt = 0; attempt < ATTEMPTS_PER_SIZE; attempt++) {
+			uint64_t multiplier = next_candidate(&state);
+			if(!try_multiplier(multiplier, bits, slots)) continue;
+
+			FILE *out = fopen(argv[1], "w");
+			if(out == NULL) {
+				perror(argv[1]);
+				return EXIT_FAILURE;
+			}
+			emit(out, multiplier, bits, slots);
+			fclose(out);
+			return EXIT_SUCCESS;
+		}
+	}
+
+	fprintf(stderr, "No collision-free hash found for the keyword set\n");
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,509 @@
+// Generates the parser from `grammar.bnf`, so that the two can not drift
+// apart. The FIRST and FOLLOW sets of every nonterminal are computed at the
+// level of token types and the grammar is checked to be LL(1), that is that
+// no token predicts two productions of the same nonterminal, failing the
+// build otherwise. Two files are written:
+// - A header with every set as a macro of case labels named after its
+//   nonterminal, with primes spelled as `_TAIL`, as in `EXPR_FOLLOWS` or
+//   `TERM_TAIL_FIRSTS`.
+// - The parse table, which gives the production each token predicts for
+//   each nonterminal, along with the loop that runs it. The loop calls back
+//   into the parser to match tokens and to run the hooks of the grammar.
+// Usage: llgen <grammar file> <header file> <parse table file>
+//
+// The grammar is made of productions, one per line, and of `%token` lines
+// that name the token types each terminal of the grammar stands for:
+//   EXPR' ::= bop @infix ATOM EXPR'
+//   %token bop TOK_OP_PLUS TOK_OP_MINUS ...
+// Empty productions are written as '' and the left side of the first
+// production is the start symbol, which is always followed by `TOK_EOF`.
+// Symbols starting with `@` are hooks, which match nothing. A production
+// starting with `other` is taken when the next token predicts none of the
+// others, without consuming it. Failing that a nonterminal falls back on its
+// empty production, or on its only one. Empty productions are also taken
+// when the file ends.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LINE 512
+#define MAX_SYMBOLS 128
+#define MAX_PRODUCTIONS 128
+#define MAX_RHS 16
+#define MAX_TOKENS 64
+#define MAX_NAME 64
+
+/// A set of token types, one bit per entry of `tokens`.
+typedef uint64_t token_set_t;
+
+typedef enum symbol_kind {
+	SYMBOL_TERMINAL,
+	SYMBOL_NONTERMINAL,
+	SYMBOL_HOOK,
+	/// The `other` of fallback productions.
+	SYMBOL_OTHER
+} symbol_kind_t;
+
+typedef struct symbol {
+	char name[MAX_NAME];
+	symbol_kind_t kind;
+	/// For terminals, the token types they stand for.
+	token_set_t tokens;
+	/// For nonterminals, whether they can expand to nothing.
+	bool nullable;
+	token_set_t first;
+	token_set_t follow;
+	/// For nonterminals, the production taken when no token predicts one,
+	/// 0 if there is none.
+	size_t fallback;
+} symbol_t;
+
+typedef struct production {
+	size_t lhs;
+	size_t rhs[MAX_RHS];
+	size_t length;
+	/// The line of the grammar the production is on.
+	unsigned line;
+} production_t;
+
+static struct grammar {
+	symbol_t symbols[MAX_SYMBOLS];
+	size_t symbol_count;
+	/// Production 0 is left unused, so that it can stand for none.
+	production_t productions[MAX_PRODUCTIONS];
+	size_t production_count;
+	/// The name of every token type in order of first mention.
+	char tokens[MAX_TOKENS][MAX_NAME];
+	size_t token_count;
+} gs = {.production_count = 1};
+
+// Internal Functions (Reading) //
+
+static void fail(const char *path, unsigned line, const char *problem, const char *what) {
+	fprintf(stderr, "%s:%u: %s \"%s\"\n", path, line, problem, what);
+	exit(EXIT_FAILURE);
+}
+
+static size_t symbol_get(const char *name) {
+	for(size_t i=0; i<gs.symbol_count; i++)
+		if(strcmp(gs.symbols[i].name, name) == 0) return i;
+	if(gs.symbol_count == MAX_SYMBOLS || strlen(name) >= MAX_NAME) {
+		fprintf(stderr, "Too many symbols or too long a name at \"%s\"\n", name);
+		exit(EXIT_FAILURE);
+	}
+	symbol_t *symbol = &gs.symbols[gs.symbol_count];
+	memset(symbol, 0, sizeof(symbol_t));
+	strcpy(symbol->name, name);
+	// Terminals until they show up on the left of a production
+	if(name[0] == '@') symbol->kind = SYMBOL_HOOK;
+	else if(strcmp(name, "other") == 0) symbol->kind = SYMBOL_OTHER;
+	else symbol->kind = SYMBOL_TERMINAL;
+	return gs.symbol_count++;
+}
+
+static token_set_t token_get(const char *name) {
+	size_t i = 0;
+	for(; i<gs.token_count; i++) if(strcmp(gs.tokens[i], name) == 0) break;
+	if(i == gs.token_count) {
+		if(gs.token_count == MAX_TOKENS || strlen(name) >= MAX_NAME) {
+			fprintf(stderr, "Too many token types or too long a name at \"%s\"\n", name);
+			exit(EXIT_FAILURE);
+		}
+		strcpy(gs.tokens[gs.token_count++], name);
+	}
+	return (token_set_t) 1 << i;
+}
+
+/// Whether a terminal stands for more than one token type.
+static bool several_tokens(const symbol_t *symbol) {
+	return (symbol->tokens & (symbol->tokens - 1)) != 0;
+}
+
+static void check_production(const char *path, const production_t *production) {
+	const char *lhs = gs.symbols[production->lhs].name;
+	if(lhs[0] == '@' || strcmp(lhs, "other") == 0)
+		fail(path, production->line, "Can not have productions for", lhs);
+	for(size_t i=0; i<production->length; i++) {
+		const symbol_t *symbol = &gs.symbols[production->rhs[i]];
+		if(symbol->kind == SYMBOL_OTHER && i != 0)
+			fail(path, production->line, "Only the start of a production can be", symbol->name);
+		// The table checks the first token of a production but the loop
+		// matches a terminal against only one token type
+		if(symbol->kind == SYMBOL_TERMINAL && several_tokens(symbol)) {
+			bool leading = true;
+			for(size_t j=0; j<i; j++) leading &= gs.symbols[production->rhs[j]].kind == SYMBOL_HOOK;
+			if(!leading || gs.symbols[production->rhs[0]].kind == SYMBOL_OTHER)
+				fail(path, production->line, "Only the first token of a production can be", symbol->name);
+		}
+	}
+}
+
+static void read_grammar(const char *path) {
+	FILE *in = fopen(path, "r");
+	if(in == NULL) perror(path), exit(EXIT_FAILURE);
+
+	char line[MAX_LINE];
+	for(unsigned number = 1; fgets(line, sizeof line, in) != NULL; number++) {
+		char *words[MAX_RHS + 2];
+		size_t count = 0;
+		for(char *word = strtok(line, " \t\r\n"); word != NULL; word = strtok(NULL, " \t\r\n")) {
+			if(count == MAX_RHS + 2) fail(path, number, "Production too long at", word);
+			words[count++] = word;
+		}
+		// Comments and the separators between sections
+		if(count == 0 || strncmp(words[0], "//", 2) == 0 || words[0][0] == '=') continue;
+
+		if(strcmp(words[0], "%token") == 0) {
+			if(count < 3) fail(path, number, "Expected a terminal and token types after", words[0]);
+			symbol_t *terminal = &gs.symbols[symbol_get(words[1])];
+			for(size_t i=2; i<count; i++) terminal->tokens |= token_get(words[i]);
+			continue;
+		}
+
+		if(count < 3 || strcmp(words[1], "::=") != 0)
+			fail(path, number, "Expected a production at", words[0]);
+		if(gs.production_count == MAX_PRODUCTIONS) fail(path, number, "Too many productions at", words[0]);
+		production_t *production = &gs.productions[gs.production_count++];
+		production->lhs = symbol_get(words[0]);
+		production->length = 0;
+		production->line = number;
+		for(size_t i=2; i<count; i++) {
+			if(strcmp(words[i], "''") == 0) continue;
+			production->rhs[production->length++] = symbol_get(words[i]);
+		}
+	}
+	fclose(in);
+
+	if(gs.production_count == 1) fail(path, 0, "No productions in", path);
+	for(size_t i=1; i<gs.production_count; i++) {
+		check_production(path, &gs.productions[i]);
+		gs.symbols[gs.productions[i].lhs].kind = SYMBOL_NONTERMINAL;
+	}
+	for(size_t i=0; i<gs.symbol_count; i++) {
+		symbol_t *symbol = &gs.symbols[i];
+		if(symbol->kind != SYMBOL_TERMINAL) continue;
+		if(symbol->tokens == 0) fail(path, 0, "No %token line for terminal", symbol->name);
+		symbol->first = symbol->tokens;
+	}
+}
+
+// Internal Functions (Analysis) //
+
+/// The FIRST set of a sequence of symbols, telling whether it is nullable.
+static token_set_t sequence_first(const size_t *sequence, size_t length, bool *nullable) {
+	token_set_t first = 0;
+	for(size_t i=0; i<length; i++) {
+		symbol_t *symbol = &gs.symbols[sequence[i]];
+		if(symbol->kind == SYMBOL_HOOK) continue;
+		// Nothing predicts `other`, it only ever starts a fallback
+		first |= symbol->first;
+		if(symbol->kind != SYMBOL_NONTERMINAL || !symbol->nullable) {
+			*nullable = false;
+			return first;
+		}
+	}
+	*nullable = true;
+	return first;
+}
+
+static void compute_sets(void) {
+	gs.symbols[gs.productions[1].lhs].follow = token_get("TOK_EOF");
+
+	// Iterate to a fixed point, the sets only ever grow
+	for(bool changed = true; changed; ) {
+		changed = false;
+		for(size_t i=1; i<gs.production_count; i++) {
+			production_t *production = &gs.productions[i];
+			symbol_t *lhs = &gs.symbols[production->lhs];
+
+			bool nullable;
+			token_set_t first = lhs->first | sequence_first(production->rhs, production->length, &nullable);
+			if(first != lhs->first || (nullable && !lhs->nullable)) changed = true;
+			lhs->first = first;
+			lhs->nullable |= nullable;
+
+			for(size_t j=0; j<production->length; j++) {
+				symbol_t *symbol = &gs.symbols[production->rhs[j]];
+				if(symbol->kind != SYMBOL_NONTERMINAL) continue;
+				bool rest_nullable;
+				token_set_t follow = symbol->follow | sequence_first(
+					&production->rhs[j + 1], production->length - j - 1, &rest_nullable);
+				if(rest_nullable) follow |= lhs->follow;
+				if(follow != symbol->follow) changed = true;
+				symbol->follow = follow;
+			}
+		}
+	}
+}
+
+/// The tokens that lead the parser to pick a production.
+static token_set_t predict(const production_t *production) {
+	bool nullable;
+	token_set_t set = sequence_first(production->rhs, production->length, &nullable);
+	if(nullable) set |= gs.symbols[production->lhs].follow | token_get("TOK_EOF");
+	return set;
+}
+
+static bool check_ll1(const char *path) {
+	bool ll1 = true;
+	for(size_t i=1; i<gs.production_count; i++) {
+		for(size_t j=i+1; j<gs.production_count; j++) {
+			production_t *a = &gs.productions[i], *b = &gs.productions[j];
+			if(a->lhs != b->lhs) continue;
+			token_set_t overlap = predict(a) & predict(b);
+			for(size_t k=0; k<gs.token_count; k++) if(overlap & ((token_set_t) 1 << k)) {
+				fprintf(stderr, "%s:%u: %s predicts both this and line %u, the grammar is not LL(1)\n",
+					path, b->line, gs.tokens[k], a->line);
+				ll1 = false;
+			}
+		}
+	}
+	return ll1;
+}
+
+static bool pick_fallbacks(const char *path) {
+	bool picked = true;
+	for(size_t i=1; i<gs.production_count; i++) {
+		production_t *production = &gs.productions[i];
+		symbol_t *lhs = &gs.symbols[production->lhs];
+		bool other = production->length > 0 && gs.symbols[production->rhs[0]].kind == SYMBOL_OTHER;
+		if(!other) continue;
+		if(lhs->fallback != 0) {
+			fprintf(stderr, "%s:%u: %s already has an other production\n", path, production->line, lhs->name);
+			picked = false;
+		}
+		lhs->fallback = i;
+	}
+	for(size_t i=0; i<gs.symbol_count; i++) {
+		symbol_t *symbol = &gs.symbols[i];
+		if(symbol->kind != SYMBOL_NONTERMINAL || symbol->fallback != 0) continue;
+		size_t count = 0, only = 0;
+		for(size_t j=1; j<gs.production_count; j++) {
+			production_t *production = &gs.productions[j];
+			if(production->lhs != i) continue;
+			count++, only = j;
+			bool nullable;
+			sequence_first(production->rhs, production->length, &nullable);
+			if(nullable) symbol->fallback = j;
+		}
+		if(symbol->fallback == 0 && count == 1) symbol->fallback = only;
+	}
+	return picked;
+}
+
+// Internal Functions (Writing) //
+
+static void emit_name(FILE *out, const char *name) {
+	for(const char *c = name; *c != '\0'; c++) {
+		if(*c == '\'') fprintf(out, "_TAIL");
+		else if(*c != '@') fputc(*c >= 'a' && *c <= 'z' ? *c - 'a' + 'A' : *c, out);
+	}
+}
+
+static void emit_set(FILE *out, const char *name, const char *suffix, token_set_t set) {
+	if(set == 0) return;
+	fprintf(out, "#define ");
+	emit_name(out, name);
+	fprintf(out, "_%s \\\n\t/*case*/ ", suffix);
+
+	bool first = true;
+	for(size_t i=0; i<gs.token_count; i++) if(set & ((token_set_t) 1 << i)) {
+		if(!first) fprintf(out, ": \\\n\tcase ");
+		fprintf(out, "%s", gs.tokens[i]);
+		first = false;
+	}
+	fprintf(out, "/*:*/\n\n");
+}
+
+static void emit_lookaheads(FILE *out, const char *path) {
+	fprintf(out, "// Generated by tools/llgen.c from %s, do not edit.\n\n", path);
+	fprintf(out, "#ifndef LOOKAHEADS_H\n#define LOOKAHEADS_H\n\n");
+	fprintf(out, "#include \"frontend/lexical/lexer.h\"\n\n");
+	for(size_t i=0; i<gs.symbol_count; i++) {
+		symbol_t *symbol = &gs.symbols[i];
+		if(symbol->kind != SYMBOL_NONTERMINAL) continue;
+		emit_set(out, symbol->name, "FIRSTS", symbol->first);
+		emit_set(out, symbol->name, "FOLLOWS", symbol->follow);
+	}
+	fprintf(out, "#endif // LOOKAHEADS_H\n");
+}
+
+static void emit_symbol(FILE *out, const symbol_t *symbol) {
+	switch(symbol->kind) {
+		case SYMBOL_TERMINAL:
+			if(several_tokens(symbol)) fprintf(out, "LL_ANY_TOKEN");
+			else for(size_t i=0; i<gs.token_count; i++)
+				if(symbol->tokens == (token_set_t) 1 << i) fprintf(out, "%s", gs.tokens[i]);
+			break;
+		case SYMBOL_NONTERMINAL: fprintf(out, "LL_"); emit_name(out, symbol->name); break;
+		case SYMBOL_HOOK: fprintf(out, "LL_HOOK_"); emit_name(out, symbol->name); break;
+		case SYMBOL_OTHER: break;
+	}
+}
+
+/// Writes out the symbols of one kind as the entries of an enum.
+static void emit_enum(FILE *out, symbol_kind_t kind, const char *first_value) {
+	bool first = true;
+	for(size_t i=0; i<gs.symbol_count; i++) {
+		if(gs.symbols[i].kind != kind) continue;
+		fprintf(out, "\t");
+		emit_symbol(out, &gs.symbols[i]);
+		if(first) fprintf(out, " = %s", first_value);
+		fprintf(out, ",\n");
+		first = false;
+	}
+}
+
+static void emit_table(FILE *out, const char *path) {
+	fprintf(out, "// Generated by tools/llgen.c from %s, do not edit.\n", path);
+	fprintf(out, "// Included by parser.c, which defines the functions declared below.\n\n");
+	fprintf(out, "#include \"common/vector.h\"\n#include \"frontend/lexical/lexer.h\"\n\n");
+	fprintf(out, "#include <assert.h>\n#include <stddef.h>\n#include <stdint.h>\n\n");
+
+	fprintf(out, "// The nonterminals and the hooks of the grammar, numbered after the token\n");
+	fprintf(out, "// types so that a symbol of the grammar fits in a byte.\n");
+	fprintf(out, "typedef enum ll_nonterminal {\n");
+	emit_enum(out, SYMBOL_NONTERMINAL, "TOK_TYPE_COUNT");
+	fprintf(out, "\tLL_NONTERMINAL_END\n} ll_nonterminal_t;\n\n");
+	fprintf(out, "typedef enum ll_hook {\n");
+	emit_enum(out, SYMBOL_HOOK, "LL_NONTERMINAL_END");
+	fprintf(out, "} ll_hook_t;\n\n");
+	// Kept out of the enum so that a switch over the hooks needs no case for it
+	size_t last_hook = 0;
+	for(size_t i=0; i<gs.symbol_count; i++) if(gs.symbols[i].kind == SYMBOL_HOOK) last_hook = i;
+	fprintf(out, "#define LL_HOOK_END (");
+	emit_symbol(out, &gs.symbols[last_hook]);
+	fprintf(out, " + 1)\n");
+	fprintf(out, "\n// Stands for a terminal of several token types, which only ever starts a\n");
+	fprintf(out, "// production so that the table already checked it.\n");
+	fprintf(out, "#define LL_ANY_TOKEN LL_HOOK_END\n");
+	fprintf(out, "typedef char ll_symbols_fit_in_a_byte[LL_ANY_TOKEN < 256 ? 1 : -1];\n\n");
+
+	fprintf(out, "// The right sides of the productions back to back, each one reversed so\n");
+	fprintf(out, "// that it is pushed onto the stack of the parse loop in order.\n");
+	fprintf(out, "static const uint8_t ll_symbols[] = {\n");
+	size_t starts[MAX_PRODUCTIONS], lengths[MAX_PRODUCTIONS], total = 0;
+	for(size_t i=1; i<gs.production_count; i++) {
+		production_t *production = &gs.productions[i];
+		starts[i] = total, lengths[i] = 0;
+		fprintf(out, "\t/* %zu: %s ::= */", i, gs.symbols[production->lhs].name);
+		for(size_t j=production->length; j-- > 0; ) {
+			symbol_t *symbol = &gs.symbols[production->rhs[j]];
+			if(symbol->kind == SYMBOL_OTHER) continue;
+			fprintf(out, " ");
+			emit_symbol(out, symbol);
+			fprintf(out, ",");
+			lengths[i]++;
+		}
+		fprintf(out, "\n");
+		total += lengths[i];
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "// Where each production is in `ll_symbols`, production 0 being none.\n");
+	fprintf(out, "static const struct ll_production {\n\tuint16_t start;\n\tuint8_t length;\n");
+	fprintf(out, "} ll_productions[] = {\n\t{0, 0},\n");
+	for(size_t i=1; i<gs.production_count; i++)
+		fprintf(out, "\t{%zu, %zu},\n", starts[i], lengths[i]);
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "// The production of each nonterminal that each token type predicts, 0 for\n");
+	fprintf(out, "// none, and the one each nonterminal falls back on then.\n");
+	fprintf(out, "static const uint8_t ll_predict[LL_NONTERMINAL_END - TOK_TYPE_COUNT][TOK_TYPE_COUNT] = {\n");
+	for(size_t i=0; i<gs.symbol_count; i++) {
+		symbol_t *symbol = &gs.symbols[i];
+		if(symbol->kind != SYMBOL_NONTERMINAL) continue;
+		fprintf(out, "\t[");
+		emit_symbol(out, symbol);
+		fprintf(out, " - TOK_TYPE_COUNT] = {");
+		bool first = true;
+		for(size_t j=1; j<gs.production_count; j++) {
+			if(gs.productions[j].lhs != i) continue;
+			token_set_t set = predict(&gs.productions[j]);
+			for(size_t k=0; k<gs.token_count; k++) if(set & ((token_set_t) 1 << k)) {
+				fprintf(out, "%s\n\t\t[%s] = %zu", first ? "" : ",", gs.tokens[k], j);
+				first = false;
+			}
+		}
+		fprintf(out, "%s},\n", first ? "0" : "\n\t");
+	}
+	fprintf(out, "};\n\n");
+	fprintf(out, "static const uint8_t ll_fallbacks[LL_NONTERMINAL_END - TOK_TYPE_COUNT] = {\n");
+	for(size_t i=0; i<gs.symbol_count; i++) {
+		symbol_t *symbol = &gs.symbols[i];
+		if(symbol->kind != SYMBOL_NONTERMINAL) continue;
+		fprintf(out, "\t[");
+		emit_symbol(out, symbol);
+		fprintf(out, " - TOK_TYPE_COUNT] = %zu,\n", symbol->fallback);
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out,
+		"VECTOR_DEFINE(ll_stack, uint8_t)\n"
+		"\n"
+		"struct parser;\n"
+		"static token_type_t ll_peek(struct parser *ps);\n"
+		"static void ll_match(struct parser *ps, token_type_t type);\n"
+		"static void ll_match_any(struct parser *ps);\n"
+		"static void ll_hook(struct parser *ps, ll_hook_t hook);\n"
+		"\n"
+		"/** Parses what a nonterminal derives to, picking its productions by the\n"
+		"  * next token. The symbols still to parse wait on a stack rather than on\n"
+		"  * the C stack, so there is no limit to how deep the input can nest.\n"
+		"  * @param stack Where to keep the symbols, which is left as it was found.\n"
+		"  */\n"
+		"static void ll_parse(struct parser *ps, ll_stack_t *stack, ll_nonterminal_t start) {\n"
+		"\tsize_t base = stack->count;\n"
+		"\tll_stack_push(stack, (uint8_t) start);\n"
+		"\t// Kept out of the vector while the hooks run, its bytes could be any of\n"
+		"\t// the memory they write to as far as the compiler knows\n"
+		"\tsize_t count = stack->count;\n"
+		"\twhile(count > base) {\n"
+		"\t\tuint8_t symbol = stack->data[--count];\n"
+		"\t\tif(symbol < TOK_TYPE_COUNT) ll_match(ps, (token_type_t) symbol);\n"
+		"\t\telse if(symbol < LL_NONTERMINAL_END) {\n"
+		"\t\t\tsize_t row = symbol - TOK_TYPE_COUNT;\n"
+		"\t\t\tuint8_t production = ll_predict[row][ll_peek(ps)];\n"
+		"\t\t\tif(production == 0) production = ll_fallbacks[row];\n"
+		"\t\t\tassert(production != 0);\n"
+		"\t\t\tconst struct ll_production *rhs = &ll_productions[production];\n"
+		"\t\t\tstack->count = count;\n"
+		"\t\t\tfor(size_t i=rhs->start; i<rhs->start + rhs->length; i++)\n"
+		"\t\t\t\tll_stack_push(stack, ll_symbols[i]);\n"
+		"\t\t\tcount = stack->count;\n"
+		"\t\t} else if(symbol < LL_HOOK_END) ll_hook(ps, (ll_hook_t) symbol);\n"
+		"\t\telse ll_match_any(ps);\n"
+		"\t}\n"
+		"\tstack->count = count;\n"
+		"}\n"
+	);
+}
+
+static bool write_file(const char *path, const char *grammar, void (*emit)(FILE *, const char *)) {
+	FILE *out = fopen(path, "w");
+	if(out == NULL) {
+		perror(path);
+		return false;
+	}
+	emit(out, grammar);
+	fclose(out);
+	return true;
+}
+
+int main(int argc, char **argv) {
+	if(argc != 4) {
+		fprintf(stderr, "Usage: %s <grammar file> <header file> <parse table file>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	read_grammar(argv[1]);
+	compute_sets();
+	if(!check_ll1(argv[1]) || !pick_fallbacks(argv[1])) return EXIT_FAILURE;
+
+	if(!write_file(argv[2], argv[1], emit_lookaheads)) return EXIT_FAILURE;
+	if(!write_file(argv[3], argv[1], emit_table)) return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}